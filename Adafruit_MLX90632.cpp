@@ -19,95 +19,326 @@
 
 // #define MLX90632_DEBUG
 
+#ifdef MLX90632_STATS
+#define MLX90632_STAT(statement) statement ///< Kept with MLX90632_STATS
+#else
+#define MLX90632_STAT(statement) ///< Compiled out without MLX90632_STATS
+#endif
+
+#define MLX90632_KELVIN ((mlx90632_real_t)273.15) ///< 0 degrees C in Kelvin
+
+#ifdef MLX90632_SINGLE_PRECISION
+#define MLX90632_SQRT sqrtf ///< sqrt() for the selected precision
+#else
+#define MLX90632_SQRT sqrt ///< sqrt() for the selected precision
+#endif
+
 /*!
- *    @brief  Instantiates a new MLX90632 class
+ *    @brief  Fourth power as two squarings
+ *    @param  x Value to raise
+ *    @return x^4, within 3 ulp of the exact result
  */
-Adafruit_MLX90632::Adafruit_MLX90632() {
-  TO0 = 25.0; // Initialize previous object temperature
-  TA0 = 25.0; // Initialize previous ambient temperature
-  i2c_dev = nullptr;
+static inline mlx90632_real_t fourthPower(mlx90632_real_t x) {
+  mlx90632_real_t x2 = x * x;
+  return x2 * x2;
+}
+
+/*!
+ *    @brief  Fourth root as two square roots
+ *    @param  x Value to take the root of, must be non-negative
+ *    @return x^(1/4). sqrt() is correctly rounded, so the result is within
+ *            1.75 ulp of the exact root: about 2e-14 K in double and 4e-5 K
+ *            in float at object temperatures up to 400 K.
+ */
+static inline mlx90632_real_t fourthRoot(mlx90632_real_t x) {
+  return MLX90632_SQRT(MLX90632_SQRT(x));
 }
 
 /*!
- *    @brief  Cleans up the MLX90632
+ *    @brief  CRC-16/CCITT-FALSE of a calibration blob, over every word
+ *            before the CRC, most significant byte first
+ *    @param  blob Blob to check
+ *    @return CRC
  */
-Adafruit_MLX90632::~Adafruit_MLX90632() {
-  if (i2c_dev) {
-    delete i2c_dev;
+static uint16_t calibrationCRC(const mlx90632_cal_blob_t& blob) {
+  const uint16_t* words = (const uint16_t*)&blob;
+  size_t count = offsetof(mlx90632_cal_blob_t, crc) / sizeof(uint16_t);
+  uint16_t crc = 0xFFFF;
+
+  for (size_t i = 0; i < count; i++) {
+    crc ^= words[i];
+    for (uint8_t bit = 0; bit < 16; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                           : (uint16_t)(crc << 1);
+    }
   }
+  return crc;
+}
+
+static void deriveCalibration(const uint16_t* ee, const uint16_t* ee_h,
+                              mlx90632_calibration_t* cal);
+
+/*!
+ *    @brief  Fill in one descriptor of an asynchronous register transaction
+ *    @param  xfer Descriptor
+ *    @param  reg Register address
+ *    @param  rx Buffer for a read, nullptr for a write
+ *    @param  rx_len Bytes to read, 0 for a write
+ *    @param  complete Completion handler
+ *    @param  context Driver the handler works on
+ *    @param  next Next descriptor, nullptr at the end of the chain
+ */
+static void initXfer(mlx90632_xfer_t* xfer, uint16_t reg, uint8_t* rx,
+                     uint8_t rx_len, mlx90632_xfer_complete_t complete,
+                     void* context, mlx90632_xfer_t* next) {
+  xfer->tx[0] = (uint8_t)(reg >> 8);
+  xfer->tx[1] = (uint8_t)(reg & 0xFF);
+  xfer->tx_len = rx ? 2 : 4;
+  xfer->rx = rx;
+  xfer->rx_len = rx_len;
+  xfer->ok = false;
+  xfer->complete = complete;
+  xfer->context = context;
+  xfer->next = next;
+}
+
+/*!
+ *    @brief  Instantiates a new MLX90632 class
+ */
+Adafruit_MLX90632::Adafruit_MLX90632() {
+  initSolver(&solver);
+  transactions = 0;
+  cal_transactions_saved = 0;
+  warm_started = false;
+  control_shadow = 0;
+  meas1_shadow = 0;
+  meas2_shadow = 0;
+  poll_state = MLX90632_STATE_IDLE;
+  poll_next_ms = 0;
+  poll_ambient = NAN;
+  poll_object = NAN;
+  poll_status = 0;
+  poll_ready_ms = 0;
+  resync_pending = false;
+  data_ready_notify = false;
+  data_ready_flag = false;
+  status_reads = 0;
+  ee_state = MLX90632_EEPROM_IDLE;
+  ee_count = 0;
+  ee_index = 0;
+  ee_cycles = 0;
+  ee_next_ms = 0;
+  ee_deadline_ms = 0;
+  ee_saved_mode = MLX90632_MODE_HALT;
+  async_callback = nullptr;
+  async_context = nullptr;
+  async_busy = false;
+  trace = nullptr;
+#ifdef MLX90632_STATS
+  resetStats();
+  stats_ready_us = 0;
+  stats_notify_us = 0;
+#endif
 }
 
 /*!
  *    @brief  Sets up the hardware and initializes I2C
  *    @param  i2c_address
  *            The I2C address to be used.
- *    @param  wire
- *            The Wire object to be used for I2C connections.
+ *    @param  bus
+ *            The bus to use: a TwoWire with the default Wire transport,
+ *            an adapter path with the Linux one, a mock bus with the mock.
  *    @return True if initialization was successful, otherwise false.
  */
-bool Adafruit_MLX90632::begin(uint8_t i2c_address, TwoWire* wire) {
-  if (i2c_dev) {
-    delete i2c_dev;
+bool Adafruit_MLX90632::begin(uint8_t i2c_address, mlx90632_bus_t* bus) {
+  uint16_t product_code;
+
+  if (!beginDevice(i2c_address, bus)) {
+    return false;
+  }
+
+  if (!readField<mlx90632_ee_product_code_t>(&product_code) ||
+      product_code == 0xFFFF || product_code == 0x0000) {
+    return false;
+  }
+
+  // Load calibration constants automatically
+  warm_started = false;
+  if (!getCalibrations()) {
+    return false;
   }
-  i2c_dev = new Adafruit_I2CDevice(i2c_address, wire);
 
-  if (!i2c_dev->begin()) {
+  // Load the CONTROL and EE_MEAS shadows
+  if (!resync()) {
     return false;
   }
 
-  Adafruit_BusIO_Register product_code_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_PRODUCT_CODE), 2, MSBFIRST, 2);
-  uint16_t product_code = product_code_reg.read();
+  return true;
+}
+
+/*!
+ *    @brief  Sets up the hardware with a stored calibration. If the blob is
+ *            valid and was exported from this chip, the calibration reads
+ *            are skipped: begin() then costs one ID burst plus the register
+ *            shadow reads. Otherwise it falls back to reading the EEPROM
+ *            like begin(uint8_t, mlx90632_bus_t*).
+ *    @param  blob Calibration from exportCalibration()
+ *    @param  i2c_address
+ *            The I2C address to be used.
+ *    @param  bus
+ *            The bus to use: a TwoWire with the default Wire transport,
+ *            an adapter path with the Linux one, a mock bus with the mock.
+ *    @return True if initialization was successful, otherwise false.
+ *            isWarmStarted() tells whether the blob was used.
+ */
+bool Adafruit_MLX90632::begin(const mlx90632_cal_blob_t& blob,
+                              uint8_t i2c_address, mlx90632_bus_t* bus) {
+  uint16_t id[MLX90632_ID_BLOCK_WORDS];
+
+  if (!checkCalibration(blob)) {
+    return begin(i2c_address, bus);
+  }
+  if (!beginDevice(i2c_address, bus)) {
+    return false;
+  }
 
+  // ID0..EE_VERSION in one burst: product ID, product code and version
+  if (!readRegisters(MLX90632_REG_ID0, id, MLX90632_ID_BLOCK_WORDS)) {
+    return false;
+  }
+  uint16_t product_code = id[MLX90632_REG_EE_PRODUCT_CODE - MLX90632_REG_ID0];
+  uint16_t version = id[MLX90632_REG_EE_VERSION - MLX90632_REG_ID0];
   if (product_code == 0xFFFF || product_code == 0x0000) {
     return false;
   }
 
-  // Load calibration constants automatically
-  if (!getCalibrations()) {
+  if (memcmp(id, blob.id, sizeof(blob.id)) == 0 &&
+      version == blob.ee_version) {
+    applyCalibration(blob.ee, blob.ee_h);
+    cal_transactions_saved = MLX90632_CAL_BLOCK_WORDS + 2;
+    warm_started = true;
+  } else {
+    // A different chip, or its EEPROM layout changed
+    warm_started = false;
+    if (!getCalibrations()) {
+      return false;
+    }
+  }
+
+  // Load the CONTROL and EE_MEAS shadows
+  return resync();
+}
+
+/*!
+ *    @brief  Bind the transport and check that something answers
+ *    @param  i2c_address The I2C address to be used
+ *    @param  bus The bus the device sits on
+ *    @return True if the device answered, false otherwise
+ */
+bool Adafruit_MLX90632::beginDevice(uint8_t i2c_address,
+                                    mlx90632_bus_t* bus) {
+  return transport.begin(i2c_address, bus);
+}
+
+/*!
+ *    @brief  Read the calibration of the chip into a blob that a later
+ *            begin() can use instead of the EEPROM. Reads the EEPROM again,
+ *            so it costs as much bus time as a cold begin().
+ *    @param  blob Blob to fill
+ *    @return True if all reads succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::exportCalibration(mlx90632_cal_blob_t* blob) {
+  uint16_t id[MLX90632_ID_BLOCK_WORDS];
+
+  if (!readRegisters(MLX90632_REG_ID0, id, MLX90632_ID_BLOCK_WORDS) ||
+      !readRegisters(MLX90632_REG_EE_P_R_LSW, blob->ee,
+                     MLX90632_CAL_BLOCK_WORDS) ||
+      !readRegisters(MLX90632_REG_EE_HA, blob->ee_h, 2)) {
     return false;
   }
 
+  blob->magic = MLX90632_CAL_BLOB_MAGIC;
+  memcpy(blob->id, id, sizeof(blob->id));
+  blob->ee_version = id[MLX90632_REG_EE_VERSION - MLX90632_REG_ID0];
+  blob->crc = calibrationCRC(*blob);
+  return true;
+}
+
+/*!
+ *    @brief  Check the magic number and CRC of a calibration blob
+ *    @param  blob Blob to check
+ *    @return True if the blob is intact, false otherwise
+ */
+bool Adafruit_MLX90632::checkCalibration(const mlx90632_cal_blob_t& blob) {
+  return blob.magic == MLX90632_CAL_BLOB_MAGIC &&
+         blob.crc == calibrationCRC(blob);
+}
+
+/*!
+ *    @brief  Derive the terms computeAmbient() and computeObject() use from
+ *            a calibration blob, without a sensor, e.g. to convert a frame
+ *            log offline
+ *    @param  blob Calibration from exportCalibration()
+ *    @param  cal Terms to fill
+ *    @return False if the blob fails checkCalibration()
+ */
+bool Adafruit_MLX90632::calibrationFromBlob(const mlx90632_cal_blob_t& blob,
+                                            mlx90632_calibration_t* cal) {
+  if (!checkCalibration(blob)) {
+    return false;
+  }
+  deriveCalibration(blob.ee, blob.ee_h, cal);
   return true;
 }
 
+/*!
+ *    @brief  Check whether the last begin() used a calibration blob
+ *    @return True if the calibration came from a blob, false if it was read
+ *            from the EEPROM
+ */
+bool Adafruit_MLX90632::isWarmStarted() {
+  return warm_started;
+}
+
 /*!
  *    @brief  Read the 48-bit product ID
- *    @return Product ID (48-bit value in uint64_t)
+ *    @return Product ID (48-bit value in uint64_t), all ones if the read
+ *            failed
  */
 uint64_t Adafruit_MLX90632::getProductID() {
-  Adafruit_BusIO_Register id0_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_ID0), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register id1_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_ID1), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register id2_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_ID2), 2, MSBFIRST, 2);
-
-  uint16_t id0 = id0_reg.read();
-  uint16_t id1 = id1_reg.read();
-  uint16_t id2 = id2_reg.read();
+  uint16_t id[3];
 
-  return ((uint64_t)id2 << 32) | ((uint64_t)id1 << 16) | id0;
+  // ID0..ID2 are consecutive, one burst reads all three
+  if (!readRegisters(mlx90632_id0_t::address(), id, 3)) {
+    return (uint64_t)-1;
+  }
+  return ((uint64_t)id[2] << 32) | ((uint64_t)id[1] << 16) | id[0];
 }
 
 /*!
  *    @brief  Read the product code
- *    @return Product code (16-bit value)
+ *    @return Product code (16-bit value), 0xFFFF if the read failed
  */
 uint16_t Adafruit_MLX90632::getProductCode() {
-  Adafruit_BusIO_Register product_code_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_PRODUCT_CODE), 2, MSBFIRST, 2);
-  return product_code_reg.read();
+  uint16_t product_code;
+
+  if (!readField<mlx90632_ee_product_code_t>(&product_code)) {
+    return 0xFFFF;
+  }
+  return product_code;
 }
 
 /*!
  *    @brief  Read the EEPROM version
- *    @return EEPROM version (16-bit value)
+ *    @return EEPROM version (16-bit value), 0xFFFF if the read failed
  */
 uint16_t Adafruit_MLX90632::getEEPROMVersion() {
-  Adafruit_BusIO_Register version_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_VERSION), 2, MSBFIRST, 2);
-  return version_reg.read();
+  uint16_t version;
+
+  if (!readField<mlx90632_ee_version_t>(&version)) {
+    return 0xFFFF;
+  }
+  return version;
 }
 
 /*!
@@ -115,12 +346,9 @@ uint16_t Adafruit_MLX90632::getEEPROMVersion() {
  *    @return True if write succeeded, false otherwise
  */
 bool Adafruit_MLX90632::startSingleMeasurement() {
-  Adafruit_BusIO_Register control_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_CONTROL), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits soc_bit =
-      Adafruit_BusIO_RegisterBits(&control_reg, 1, 3);
-
-  return soc_bit.write(1);
+  // SOC self-clears, so it is not kept in the shadow
+  return writeRegister(mlx90632_control_soc_t::address(),
+                       mlx90632_control_soc_t::set(control_shadow, 1));
 }
 
 /*!
@@ -128,12 +356,9 @@ bool Adafruit_MLX90632::startSingleMeasurement() {
  *    @return True if write succeeded, false otherwise
  */
 bool Adafruit_MLX90632::startFullMeasurement() {
-  Adafruit_BusIO_Register control_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_CONTROL), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits sob_bit =
-      Adafruit_BusIO_RegisterBits(&control_reg, 1, 11);
-
-  return sob_bit.write(1);
+  // SOB self-clears, so it is not kept in the shadow
+  return writeRegister(mlx90632_control_sob_t::address(),
+                       mlx90632_control_sob_t::set(control_shadow, 1));
 }
 
 /*!
@@ -142,25 +367,15 @@ bool Adafruit_MLX90632::startFullMeasurement() {
  *    @return True if write succeeded, false otherwise
  */
 bool Adafruit_MLX90632::setMode(mlx90632_mode_t mode) {
-  Adafruit_BusIO_Register control_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_CONTROL), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits mode_bits =
-      Adafruit_BusIO_RegisterBits(&control_reg, 2, 1);
-
-  return mode_bits.write(mode);
+  return writeField<mlx90632_control_mode_t>(&control_shadow, mode);
 }
 
 /*!
  *    @brief  Get the measurement mode
- *    @return The current measurement mode
+ *    @return The current measurement mode (from the driver-side shadow)
  */
 mlx90632_mode_t Adafruit_MLX90632::getMode() {
-  Adafruit_BusIO_Register control_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_CONTROL), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits mode_bits =
-      Adafruit_BusIO_RegisterBits(&control_reg, 2, 1);
-
-  return (mlx90632_mode_t)mode_bits.read();
+  return (mlx90632_mode_t)mlx90632_control_mode_t::get(control_shadow);
 }
 
 /*!
@@ -170,25 +385,74 @@ mlx90632_mode_t Adafruit_MLX90632::getMode() {
  */
 bool Adafruit_MLX90632::setMeasurementSelect(
     mlx90632_meas_select_t meas_select) {
-  Adafruit_BusIO_Register control_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_CONTROL), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits meas_select_bits =
-      Adafruit_BusIO_RegisterBits(&control_reg, 5, 4);
-
-  return meas_select_bits.write(meas_select);
+  if (!writeField<mlx90632_control_meas_select_t>(&control_shadow,
+                                                  meas_select)) {
+    return false;
+  }
+  // The medical RAM words start over with the new measurement table
+  solver.half = 0;
+  solver.halves = 0;
+  return true;
 }
 
 /*!
  *    @brief  Get the measurement select type
- *    @return The current measurement select type
+ *    @return The current measurement select type (from the driver-side
+ *            shadow)
  */
 mlx90632_meas_select_t Adafruit_MLX90632::getMeasurementSelect() {
-  Adafruit_BusIO_Register control_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_CONTROL), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits meas_select_bits =
-      Adafruit_BusIO_RegisterBits(&control_reg, 5, 4);
+  return (mlx90632_meas_select_t)mlx90632_control_meas_select_t::get(
+      control_shadow);
+}
+
+/*!
+ *    @brief  Re-read CONTROL, EE_MEAS_1 and EE_MEAS_2 into the driver-side
+ *            shadows. Call this if the device may have changed underneath
+ *            the driver, e.g. after an external reset.
+ *    @return True if all reads succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::resync() {
+  uint16_t meas[2];
+
+  if (!readRegisters(MLX90632_REG_CONTROL, &control_shadow, 1) ||
+      !readRegisters(MLX90632_REG_EE_MEAS_1, meas, 2)) {
+    return false;
+  }
+  meas1_shadow = meas[0];
+  meas2_shadow = meas[1];
+  return true;
+}
+
+/*!
+ *    @brief  Read the STATUS register once and decode all of its fields, so
+ *            a loop that needs several of them costs one transaction and
+ *            sees a consistent snapshot
+ *    @param  status Snapshot to fill
+ *    @return True if the read succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::readStatus(mlx90632_status_t* status) {
+  uint16_t raw;
 
-  return (mlx90632_meas_select_t)meas_select_bits.read();
+  if (!readStatusWord(&raw)) {
+    return false;
+  }
+  decodeStatus(raw, status);
+  return true;
+}
+
+/*!
+ *    @brief  Decode a raw STATUS register value, e.g. the one stored in an
+ *            mlx90632_sample_t
+ *    @param  raw STATUS register value
+ *    @param  status Snapshot to fill
+ */
+void Adafruit_MLX90632::decodeStatus(uint16_t raw, mlx90632_status_t* status) {
+  status->raw = raw;
+  status->new_data = mlx90632_status_new_data_t::get(raw);
+  status->cycle_position = mlx90632_status_cycle_position_t::get(raw);
+  status->brown_out = mlx90632_status_brown_out_t::get(raw);
+  status->eeprom_busy = mlx90632_status_eeprom_busy_t::get(raw);
+  status->device_busy = mlx90632_status_device_busy_t::get(raw);
 }
 
 /*!
@@ -196,12 +460,9 @@ mlx90632_meas_select_t Adafruit_MLX90632::getMeasurementSelect() {
  *    @return True if device is busy, false otherwise
  */
 bool Adafruit_MLX90632::isBusy() {
-  Adafruit_BusIO_Register status_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_STATUS), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits device_busy_bit =
-      Adafruit_BusIO_RegisterBits(&status_reg, 1, 10);
+  mlx90632_status_t status;
 
-  return device_busy_bit.read();
+  return readStatus(&status) && status.device_busy;
 }
 
 /*!
@@ -209,29 +470,39 @@ bool Adafruit_MLX90632::isBusy() {
  *    @return True if EEPROM is busy, false otherwise
  */
 bool Adafruit_MLX90632::isEEPROMBusy() {
-  Adafruit_BusIO_Register status_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_STATUS), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits eeprom_busy_bit =
-      Adafruit_BusIO_RegisterBits(&status_reg, 1, 9);
+  mlx90632_status_t status;
 
-  return eeprom_busy_bit.read();
+  return readStatus(&status) && status.eeprom_busy;
 }
 
 /*!
  *    @brief  Reset device using addressed reset command
+ *    @param  wait If true (the default), wait for the reset to complete and
+ *            reload the register shadows before returning. If false, return
+ *            immediately and let poll() finish the reset without blocking.
  *    @return True if reset succeeded, false otherwise
  */
-bool Adafruit_MLX90632::reset() {
-  // Send addressed reset command: 0x3005, 0x0006
-  uint8_t reset_cmd[] = {0x30, 0x05, 0x00, 0x06};
-  if (!i2c_dev->write(reset_cmd, 4)) {
+bool Adafruit_MLX90632::reset(bool wait) {
+  // Send addressed reset command
+  if (!writeRegister(MLX90632_REG_I2C_COMMAND, MLX90632_CMD_RESET)) {
     return false;
   }
+  solver.half = 0;
+  solver.halves = 0;
+
+  if (!wait) {
+    // poll() holds off for the reset time, then reloads the shadows
+    poll_state = MLX90632_STATE_IDLE;
+    poll_next_ms = millis() + 1;
+    resync_pending = true;
+    return true;
+  }
 
   // Wait for reset to complete (at least 150us as per datasheet)
   delay(1);
 
-  return true;
+  // Reset reloads CONTROL from EEPROM
+  return resync();
 }
 
 /*!
@@ -239,25 +510,30 @@ bool Adafruit_MLX90632::reset() {
  *    @return Current cycle position (0-31)
  */
 uint8_t Adafruit_MLX90632::readCyclePosition() {
-  Adafruit_BusIO_Register status_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_STATUS), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits cycle_position_bits =
-      Adafruit_BusIO_RegisterBits(&status_reg, 5, 2);
+  mlx90632_status_t status;
 
-  return cycle_position_bits.read();
+  if (!readStatus(&status)) {
+    return 0;
+  }
+  return status.cycle_position;
 }
 
 /*!
  *    @brief  Reset the new data flag to 0
+ *    @param  status Snapshot from readStatus() to write back with new_data
+ *            cleared, saving a status read. If nullptr (the default), the
+ *            register is read first.
  *    @return True if write succeeded, false otherwise
  */
-bool Adafruit_MLX90632::resetNewData() {
-  Adafruit_BusIO_Register status_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_STATUS), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits new_data_bit =
-      Adafruit_BusIO_RegisterBits(&status_reg, 1, 0);
+bool Adafruit_MLX90632::resetNewData(const mlx90632_status_t* status) {
+  uint16_t raw;
 
-  return new_data_bit.write(0);
+  if (status) {
+    raw = status->raw;
+  } else if (!readStatusWord(&raw)) {
+    return false;
+  }
+  return writeField<mlx90632_status_new_data_t>(&raw, 0);
 }
 
 /*!
@@ -265,67 +541,453 @@ bool Adafruit_MLX90632::resetNewData() {
  *    @return True if new data is available, false otherwise
  */
 bool Adafruit_MLX90632::isNewData() {
-  Adafruit_BusIO_Register status_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_STATUS), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits new_data_bit =
-      Adafruit_BusIO_RegisterBits(&status_reg, 1, 0);
+  mlx90632_status_t status;
 
-  return new_data_bit.read();
+  return readStatus(&status) && status.new_data;
 }
 
 /*!
- *    @brief  Set the refresh rate for both measurement registers
+ *    @brief  Set the refresh rate for both measurement registers. This is an
+ *            EEPROM write session: it does nothing if the rate is already
+ *            set, and otherwise blocks for the erase and write cycles.
  *    @param  refresh_rate The refresh rate to set
- *    @return True if both writes succeeded, false otherwise
+ *    @return True if both words were written (or already set), false
+ *            otherwise
  */
 bool Adafruit_MLX90632::setRefreshRate(mlx90632_refresh_rate_t refresh_rate) {
-  // Set refresh rate in EE_MEAS_1 register (bits 10:8)
-  Adafruit_BusIO_Register meas1_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_MEAS_1), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits meas1_refresh_bits =
-      Adafruit_BusIO_RegisterBits(&meas1_reg, 3, 8);
+  // Both measurements of the table run at the same rate
+  return beginEEPROMWrite() &&
+         writeEEPROM(MLX90632_REG_EE_MEAS_1,
+                     mlx90632_ee_meas1_refresh_t::set(0, refresh_rate),
+                     mlx90632_ee_meas1_refresh_t::mask()) &&
+         writeEEPROM(MLX90632_REG_EE_MEAS_2,
+                     mlx90632_ee_meas2_refresh_t::set(0, refresh_rate),
+                     mlx90632_ee_meas2_refresh_t::mask()) &&
+         commitEEPROM();
+}
+
+/*!
+ *    @brief  Open an EEPROM write session. Queue words with writeEEPROM(),
+ *            then run them all in one halted session with commitEEPROM().
+ *    @return True if the session was opened, false if another one is still
+ *            running
+ */
+bool Adafruit_MLX90632::beginEEPROMWrite() {
+  if (ee_state == MLX90632_EEPROM_HALTING ||
+      ee_state == MLX90632_EEPROM_ERASING ||
+      ee_state == MLX90632_EEPROM_WRITING) {
+    return false;
+  }
+  ee_state = MLX90632_EEPROM_QUEUED;
+  ee_count = 0;
+  ee_index = 0;
+  ee_cycles = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Queue bits of an EEPROM word for the open session. Writes to
+ *            the same word are merged. Nothing touches the bus until
+ *            commitEEPROM().
+ *    @param  addr EEPROM address, EE_HA or above; the Melexis calibration
+ *            below it is refused
+ *    @param  value New value of the masked bits
+ *    @param  mask Bits to change, the whole word by default
+ *    @return True if queued, false if no session is open, the address is
+ *            refused or the queue is full
+ */
+bool Adafruit_MLX90632::writeEEPROM(uint16_t addr, uint16_t value,
+                                    uint16_t mask) {
+  if (ee_state != MLX90632_EEPROM_QUEUED || addr < MLX90632_REG_EE_HA ||
+      addr > MLX90632_REG_EE_LAST) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < ee_count; i++) {
+    if (ee_queue[i].addr == addr) {
+      ee_queue[i].value = (ee_queue[i].value & ~mask) | (value & mask);
+      ee_queue[i].mask |= mask;
+      return true;
+    }
+  }
+  if (ee_count >= MLX90632_EEPROM_QUEUE) {
+    return false;
+  }
+  ee_queue[ee_count].addr = addr;
+  ee_queue[ee_count].mask = mask;
+  ee_queue[ee_count].value = value & mask;
+  ee_count++;
+  return true;
+}
+
+/*!
+ *    @brief  Run the queued EEPROM writes. Words that already hold the new
+ *            value are dropped, so a session without changes costs no
+ *            EEPROM cycle and does not halt the device. Otherwise the
+ *            device is halted, each word is unlocked and erased (unless it
+ *            already is) and then unlocked and written, and the previous
+ *            mode is restored. A cycle still busy after
+ *            MLX90632_EEPROM_TIMEOUT_MS, or a measurement that doesn't
+ *            end within a refresh period, fails the session.
+ *    @param  wait If true (the default), block until the session ends. If
+ *            false, return after starting it and let pollEEPROM() run it.
+ *    @return True if the session completed (or started, when not waiting),
+ *            false otherwise
+ */
+bool Adafruit_MLX90632::commitEEPROM(bool wait) {
+  uint8_t count = 0;
+
+  if (ee_state != MLX90632_EEPROM_QUEUED) {
+    return false;
+  }
+
+  // Compare against the current words, from the shadows where the driver
+  // keeps them
+  for (uint8_t i = 0; i < ee_count; i++) {
+    mlx90632_eeprom_write_t entry = ee_queue[i];
+
+    if (entry.addr == MLX90632_REG_EE_MEAS_1) {
+      entry.old = meas1_shadow;
+    } else if (entry.addr == MLX90632_REG_EE_MEAS_2) {
+      entry.old = meas2_shadow;
+    } else if (!readRegisters(entry.addr, &entry.old, 1)) {
+      ee_state = MLX90632_EEPROM_FAILED;
+      return false;
+    }
+    entry.value = (entry.old & ~entry.mask) | entry.value;
+    if (entry.value != entry.old) {
+      ee_queue[count++] = entry;
+    }
+  }
+  ee_count = count;
+  ee_index = 0;
+  ee_saved_mode = getMode();
+
+  if (ee_count == 0) {
+    ee_state = MLX90632_EEPROM_DONE;
+    return true;
+  }
+
+  // Halt measurements for the whole session
+  if (ee_saved_mode != MLX90632_MODE_HALT && !setMode(MLX90632_MODE_HALT)) {
+    ee_state = MLX90632_EEPROM_FAILED;
+    return false;
+  }
+  ee_state = MLX90632_EEPROM_HALTING;
+  ee_next_ms = millis();
+  // The running measurement takes up to one refresh period
+  ee_deadline_ms = ee_next_ms + getRefreshPeriod() + MLX90632_EEPROM_TIMEOUT_MS;
+
+  if (!wait) {
+    return true;
+  }
+  while (pollEEPROM() != MLX90632_EEPROM_DONE &&
+         ee_state != MLX90632_EEPROM_FAILED) {
+    delay(1);
+  }
+  return ee_state == MLX90632_EEPROM_DONE;
+}
+
+/*!
+ *    @brief  Advance a session started with commitEEPROM(false). Call this
+ *            often from loop(); it reads the status only when a busy check
+ *            is due and never waits.
+ *    @return The new state, MLX90632_EEPROM_DONE or MLX90632_EEPROM_FAILED
+ *            once the session has ended
+ */
+mlx90632_eeprom_state_t Adafruit_MLX90632::pollEEPROM() {
+  uint32_t now = millis();
+  mlx90632_status_t status;
+
+  if ((ee_state != MLX90632_EEPROM_HALTING &&
+       ee_state != MLX90632_EEPROM_ERASING &&
+       ee_state != MLX90632_EEPROM_WRITING) ||
+      (int32_t)(now - ee_next_ms) < 0) {
+    return ee_state;
+  }
+
+  if (!readStatus(&status)) {
+    return finishEEPROM(false);
+  }
+  if ((ee_state == MLX90632_EEPROM_HALTING && status.device_busy) ||
+      (ee_state != MLX90632_EEPROM_HALTING && status.eeprom_busy)) {
+    // A device that stays busy must not hold the session open forever
+    if ((int32_t)(now - ee_deadline_ms) >= 0) {
+      return finishEEPROM(false);
+    }
+    ee_next_ms = now + 1;
+    return ee_state;
+  }
+
+  if (ee_state == MLX90632_EEPROM_ERASING) {
+    ee_queue[ee_index].old = 0;
+  } else if (ee_state == MLX90632_EEPROM_WRITING) {
+    ee_queue[ee_index].old = ee_queue[ee_index].value;
+  }
+  if (!startEEPROMWord()) {
+    return finishEEPROM(false);
+  }
+  return ee_state;
+}
 
-  if (!meas1_refresh_bits.write(refresh_rate)) {
+/*!
+ *    @brief  Start the next erase or write cycle of the session, or end it
+ *            when every word holds its new value
+ *    @return True unless a bus transfer failed
+ */
+bool Adafruit_MLX90632::startEEPROMWord() {
+  while (ee_index < ee_count) {
+    mlx90632_eeprom_write_t* entry = &ee_queue[ee_index];
+
+    if (entry->old != entry->value) {
+      // A word must be erased (to 0) before it can be written
+      ee_state = entry->old ? MLX90632_EEPROM_ERASING : MLX90632_EEPROM_WRITING;
+      return eraseOrWriteEEPROM(entry->addr, entry->old ? 0 : entry->value);
+    }
+
+    if (entry->addr == MLX90632_REG_EE_MEAS_1) {
+      meas1_shadow = entry->value;
+    } else if (entry->addr == MLX90632_REG_EE_MEAS_2) {
+      meas2_shadow = entry->value;
+    }
+    ee_index++;
+  }
+  finishEEPROM(true);
+  return true;
+}
+
+/*!
+ *    @brief  Unlock the EEPROM and start one erase (value 0) or write cycle
+ *    @param  addr EEPROM address
+ *    @param  value Value to write, 0 to erase
+ *    @return True if both transfers succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::eraseOrWriteEEPROM(uint16_t addr, uint16_t value) {
+  // The unlock key only covers the next EEPROM access
+  if (!writeRegister(MLX90632_REG_I2C_COMMAND, MLX90632_CMD_EE_UNLOCK) ||
+      !writeRegister(addr, value)) {
     return false;
   }
+  ee_cycles++;
+  uint32_t now = millis();
+  ee_next_ms = now + MLX90632_EEPROM_CYCLE_MS;
+  ee_deadline_ms = now + MLX90632_EEPROM_TIMEOUT_MS;
+  return true;
+}
 
-  // Set refresh rate in EE_MEAS_2 register (bits 10:8)
-  Adafruit_BusIO_Register meas2_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_MEAS_2), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits meas2_refresh_bits =
-      Adafruit_BusIO_RegisterBits(&meas2_reg, 3, 8);
+/*!
+ *    @brief  End the EEPROM session and restore the measurement mode
+ *    @param  ok False if the session failed
+ *    @return MLX90632_EEPROM_DONE or MLX90632_EEPROM_FAILED
+ */
+mlx90632_eeprom_state_t Adafruit_MLX90632::finishEEPROM(bool ok) {
+  if (ee_saved_mode != MLX90632_MODE_HALT && !setMode(ee_saved_mode)) {
+    ok = false;
+  }
+  ee_state = ok ? MLX90632_EEPROM_DONE : MLX90632_EEPROM_FAILED;
+  return ee_state;
+}
 
-  return meas2_refresh_bits.write(refresh_rate);
+/*!
+ *    @brief  Get the number of EEPROM erase and write cycles of the last
+ *            session, 0 if every word already held its new value
+ *    @return Number of cycles
+ */
+uint8_t Adafruit_MLX90632::getEEPROMCycles() {
+  return ee_cycles;
 }
 
 /*!
  *    @brief  Get the refresh rate from EE_MEAS_1 register
- *    @return The current refresh rate
+ *    @return The current refresh rate (from the driver-side shadow)
  */
 mlx90632_refresh_rate_t Adafruit_MLX90632::getRefreshRate() {
-  Adafruit_BusIO_Register meas1_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_MEAS_1), 2, MSBFIRST, 2);
-  Adafruit_BusIO_RegisterBits meas1_refresh_bits =
-      Adafruit_BusIO_RegisterBits(&meas1_reg, 3, 8);
+  return (mlx90632_refresh_rate_t)mlx90632_ee_meas1_refresh_t::get(
+      meas1_shadow);
+}
 
-  return (mlx90632_refresh_rate_t)meas1_refresh_bits.read();
+/*!
+ *    @brief  Write a single 16-bit register
+ *    @param  addr Address of the register to write
+ *    @param  value Value to write
+ *    @return True if the write succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::writeRegister(uint16_t addr, uint16_t value) {
+  uint8_t buffer[4] = {(uint8_t)(addr >> 8), (uint8_t)(addr & 0xFF),
+                       (uint8_t)(value >> 8), (uint8_t)(value & 0xFF)};
+
+  transactions++;
+  MLX90632_STAT(stats.transactions++);
+  bool ok = transport.write(buffer, 4);
+  if (trace) {
+    trace->record(false, ok, addr, buffer + 2, 2);
+  }
+  if (!ok) {
+    MLX90632_STAT(stats.failed_writes++);
+    return false;
+  }
+  return true;
 }
 
 /*!
- *    @brief  Helper function to read 32-bit values from consecutive registers
- *    @param  lsw_addr Address of the least significant word register
+ *    @brief  Burst read consecutive 16-bit registers
+ *    @param  start_addr Address of the first register to read
+ *    @param  words Buffer to hold the register values
+ *    @param  count Number of 16-bit registers to read
+ *    @return True if all reads succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::readRegisters(uint16_t start_addr, uint16_t* words,
+                                      uint16_t count) {
+  // The device auto-increments the register address, so read as many words
+  // per transaction as the bus buffer allows
+  uint8_t buffer[2 * MLX90632_MAX_BURST_WORDS];
+  size_t chunk = transport.maxBufferSize() / 2;
+  if (chunk > MLX90632_MAX_BURST_WORDS) {
+    chunk = MLX90632_MAX_BURST_WORDS;
+  }
+  // A bus that can't carry one word would never make progress
+  if (chunk == 0) {
+    return false;
+  }
+
+  while (count > 0) {
+    uint16_t n = (count < chunk) ? count : (uint16_t)chunk;
+    uint8_t addr[2] = {(uint8_t)(start_addr >> 8),
+                       (uint8_t)(start_addr & 0xFF)};
+
+    transactions++;
+    MLX90632_STAT(stats.transactions++);
+    bool ok = transport.writeThenRead(addr, 2, buffer, 2 * n);
+    if (trace) {
+      trace->record(true, ok, start_addr, buffer, 2 * n);
+    }
+    if (!ok) {
+      MLX90632_STAT(stats.failed_reads++);
+      return false;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+      words[i] = ((uint16_t)buffer[2 * i] << 8) | buffer[2 * i + 1];
+    }
+
+    start_addr += n;
+    words += n;
+    count -= n;
+  }
+
+  return true;
+}
+
+/*!
+ *    @brief  Compile-time power of two for the datasheet scaling factors
+ *    @param  n Exponent
+ *    @return 2^n
+ */
+static constexpr double pow2(int n) {
+  return (n == 0) ? 1.0 : ((n > 0) ? 2.0 * pow2(n - 1) : 0.5 * pow2(n + 1));
+}
+
+/*!
+ *    @brief  Combine two consecutive EEPROM words into a signed 32-bit value
+ *    @param  words Buffer holding the EEPROM words
+ *    @param  lsw_index Index of the least significant word in the buffer
  *    @return 32-bit value (LSW + MSW)
  */
-uint32_t Adafruit_MLX90632::read32BitRegister(uint16_t lsw_addr) {
-  Adafruit_BusIO_Register lsw_reg =
-      Adafruit_BusIO_Register(i2c_dev, swapBytes(lsw_addr), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register msw_reg =
-      Adafruit_BusIO_Register(i2c_dev, swapBytes(lsw_addr + 1), 2, MSBFIRST, 2);
+static int32_t eeWord32(const uint16_t* words, uint16_t lsw_index) {
+  return (int32_t)(((uint32_t)words[lsw_index + 1] << 16) | words[lsw_index]);
+}
+
+/*!
+ *    @brief  Calibration constants in datasheet units, see
+ *            decodeCalibration()
+ */
+typedef struct {
+  double P_R; ///< P_R calibration constant
+  double P_G; ///< P_G calibration constant
+  double P_T; ///< P_T calibration constant
+  double P_O; ///< P_O calibration constant
+  double Aa;  ///< Aa calibration constant
+  double Ab;  ///< Ab calibration constant
+  double Ba;  ///< Ba calibration constant
+  double Bb;  ///< Bb calibration constant
+  double Ca;  ///< Ca calibration constant
+  double Cb;  ///< Cb calibration constant
+  double Da;  ///< Da calibration constant
+  double Db;  ///< Db calibration constant
+  double Ea;  ///< Ea calibration constant
+  double Eb;  ///< Eb calibration constant
+  double Fa;  ///< Fa calibration constant
+  double Fb;  ///< Fb calibration constant
+  double Ga;  ///< Ga calibration constant
+  double Gb;  ///< Gb calibration constant
+  double Ka;  ///< Ka calibration constant
+  int16_t Kb; ///< Kb calibration constant (16-bit signed)
+  double Ha;  ///< Ha calibration constant
+  double Hb;  ///< Hb calibration constant
+} mlx90632_ee_constants_t;
+
+/*!
+ *    @brief  Convert raw calibration words to constants. The only place
+ *            that knows the datasheet scaling factors.
+ *    @param  ee Raw words EE_P_R_LSW..EE_KB
+ *    @param  ee_h Raw words EE_HA and EE_HB
+ *    @param  c Constants to fill
+ */
+static void decodeCalibration(const uint16_t* ee, const uint16_t* ee_h,
+                              mlx90632_ee_constants_t* c) {
+#define EE_INDEX(reg) ((reg) - MLX90632_REG_EE_P_R_LSW)
+
+  // Convert to proper double values with scaling factors from datasheet
+  c->P_R = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_P_R_LSW)) * pow2(-8);
+  c->P_G = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_P_G_LSW)) * pow2(-20);
+  c->P_T = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_P_T_LSW)) * pow2(-44);
+  c->P_O = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_P_O_LSW)) * pow2(-8);
+  c->Aa = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_AA_LSW)) * pow2(-16);
+  c->Ab = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_AB_LSW)) * pow2(-8);
+  c->Ba = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_BA_LSW)) * pow2(-16);
+  c->Bb = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_BB_LSW)) * pow2(-8);
+  c->Ca = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_CA_LSW)) * pow2(-16);
+  c->Cb = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_CB_LSW)) * pow2(-8);
+  c->Da = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_DA_LSW)) * pow2(-16);
+  c->Db = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_DB_LSW)) * pow2(-8);
+  c->Ea = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_EA_LSW)) * pow2(-16);
+  c->Eb = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_EB_LSW)) * pow2(-8);
+  c->Fa = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_FA_LSW)) * pow2(-46);
+  c->Fb = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_FB_LSW)) * pow2(-36);
+  c->Ga = (double)eeWord32(ee, EE_INDEX(MLX90632_REG_EE_GA_LSW)) * pow2(-36);
 
-  uint16_t lsw = lsw_reg.read();
-  uint16_t msw = msw_reg.read();
+  // 16-bit signed values with scaling
+  c->Gb = (double)(int16_t)ee[EE_INDEX(MLX90632_REG_EE_GB)] * pow2(-10);
+  c->Ka = (double)(int16_t)ee[EE_INDEX(MLX90632_REG_EE_KA)] * pow2(-10);
+  c->Kb = (int16_t)ee[EE_INDEX(MLX90632_REG_EE_KB)]; // No scaling
+  c->Ha = (double)(int16_t)ee_h[0] * pow2(-14);
+  c->Hb = (double)(int16_t)ee_h[1] * pow2(-10);
+
+#undef EE_INDEX
+}
 
-  return ((uint32_t)msw << 16) | lsw;
+/*!
+ *    @brief  Fold raw calibration words into the terms used by every sample
+ *    @param  ee Raw words EE_P_R_LSW..EE_KB
+ *    @param  ee_h Raw words EE_HA and EE_HB
+ *    @param  cal Terms to fill
+ */
+static void deriveCalibration(const uint16_t* ee, const uint16_t* ee_h,
+                              mlx90632_calibration_t* cal) {
+  mlx90632_ee_constants_t c;
+
+  decodeCalibration(ee, ee_h, &c);
+  cal->P_R = c.P_R;
+  cal->inv_P_G = 1.0 / c.P_G;
+  cal->P_T = c.P_T;
+  cal->P_O = c.P_O;
+  cal->Gb_12 = c.Gb / 12.0;
+  cal->Ka_12 = c.Ka / 12.0;
+  cal->Eb = c.Eb;
+  cal->inv_Ea = 1.0 / c.Ea;
+  cal->Ga = c.Ga;
+  cal->Fb = c.Fb;
+  cal->inv_emiss_FaHa = 1.0 / (MLX90632_EMISSIVITY * c.Fa * c.Ha);
+  cal->Hb_K = c.Hb + 273.15;
 }
 
 /*!
@@ -333,165 +995,244 @@ uint32_t Adafruit_MLX90632::read32BitRegister(uint16_t lsw_addr) {
  *    @return True if all reads succeeded, false otherwise
  */
 bool Adafruit_MLX90632::getCalibrations() {
-  // Read 32-bit calibration constants
-  uint32_t ee_p_r = read32BitRegister(MLX90632_REG_EE_P_R_LSW);
-  uint32_t ee_p_g = read32BitRegister(MLX90632_REG_EE_P_G_LSW);
-  uint32_t ee_p_t = read32BitRegister(MLX90632_REG_EE_P_T_LSW);
-  uint32_t ee_p_o = read32BitRegister(MLX90632_REG_EE_P_O_LSW);
-  uint32_t ee_aa = read32BitRegister(MLX90632_REG_EE_AA_LSW);
-  uint32_t ee_ab = read32BitRegister(MLX90632_REG_EE_AB_LSW);
-  uint32_t ee_ba = read32BitRegister(MLX90632_REG_EE_BA_LSW);
-  uint32_t ee_bb = read32BitRegister(MLX90632_REG_EE_BB_LSW);
-  uint32_t ee_ca = read32BitRegister(MLX90632_REG_EE_CA_LSW);
-  uint32_t ee_cb = read32BitRegister(MLX90632_REG_EE_CB_LSW);
-  uint32_t ee_da = read32BitRegister(MLX90632_REG_EE_DA_LSW);
-  uint32_t ee_db = read32BitRegister(MLX90632_REG_EE_DB_LSW);
-  uint32_t ee_ea = read32BitRegister(MLX90632_REG_EE_EA_LSW);
-  uint32_t ee_eb = read32BitRegister(MLX90632_REG_EE_EB_LSW);
-  uint32_t ee_fa = read32BitRegister(MLX90632_REG_EE_FA_LSW);
-  uint32_t ee_fb = read32BitRegister(MLX90632_REG_EE_FB_LSW);
-  uint32_t ee_ga = read32BitRegister(MLX90632_REG_EE_GA_LSW);
-
-  // Read 16-bit calibration constants
-  Adafruit_BusIO_Register gb_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_GB), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register ka_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_KA), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register kb_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_KB), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register ha_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_HA), 2, MSBFIRST, 2);
-  Adafruit_BusIO_Register hb_reg = Adafruit_BusIO_Register(
-      i2c_dev, swapBytes(MLX90632_REG_EE_HB), 2, MSBFIRST, 2);
+  uint16_t ee[MLX90632_CAL_BLOCK_WORDS];
+  uint16_t ee_h[2];
+  uint32_t start_transactions = transactions;
 
-  // Convert to proper double values with scaling factors from datasheet
-  P_R = (double)(int32_t)ee_p_r * (double)pow(2, -8);  // 2^-8
-  P_G = (double)(int32_t)ee_p_g * (double)pow(2, -20); // 2^-20
-  P_T = (double)(int32_t)ee_p_t * (double)pow(2, -44); // 2^-44
-  P_O = (double)(int32_t)ee_p_o * (double)pow(2, -8);  // 2^-8
-  Aa = (double)(int32_t)ee_aa * (double)pow(2, -16);   // 2^-16
-  Ab = (double)(int32_t)ee_ab * (double)pow(2, -8);    // 2^-8
-  Ba = (double)(int32_t)ee_ba * (double)pow(2, -16);   // 2^-16
-  Bb = (double)(int32_t)ee_bb * (double)pow(2, -8);    // 2^-8
-  Ca = (double)(int32_t)ee_ca * (double)pow(2, -16);   // 2^-16
-  Cb = (double)(int32_t)ee_cb * (double)pow(2, -8);    // 2^-8
-  Da = (double)(int32_t)ee_da * (double)pow(2, -16);   // 2^-16
-  Db = (double)(int32_t)ee_db * (double)pow(2, -8);    // 2^-8
-  Ea = (double)(int32_t)ee_ea * (double)pow(2, -16);   // 2^-16
-  Eb = (double)(int32_t)ee_eb * (double)pow(2, -8);    // 2^-8
-  Fa = (double)(int32_t)ee_fa * (double)pow(2, -46);   // 2^-46
-  Fb = (double)(int32_t)ee_fb * (double)pow(2, -36);   // 2^-36
-  Ga = (double)(int32_t)ee_ga * (double)pow(2, -36);   // 2^-36
+  // P_R through Kb are one contiguous block, Ha and Hb are a second block
+  if (!readRegisters(MLX90632_REG_EE_P_R_LSW, ee, MLX90632_CAL_BLOCK_WORDS) ||
+      !readRegisters(MLX90632_REG_EE_HA, ee_h, 2)) {
+    return false;
+  }
 
-  // 16-bit signed values with scaling
-  Gb = (double)(int16_t)gb_reg.read() * (double)pow(2, -10); // 2^-10
-  Ka = (double)(int16_t)ka_reg.read() * (double)pow(2, -10); // 2^-10
-  Kb = (int16_t)kb_reg.read();                               // No scaling
-  Ha = (double)(int16_t)ha_reg.read() * (double)pow(2, -14); // 2^-14
-  Hb = (double)(int16_t)hb_reg.read() * (double)pow(2, -10); // 2^-10
+  // Reading each word on its own costs one transaction per word
+  cal_transactions_saved =
+      (MLX90632_CAL_BLOCK_WORDS + 2) - (transactions - start_transactions);
+
+  applyCalibration(ee, ee_h);
+  return true;
+}
+
+/*!
+ *    @brief  Convert raw calibration words to the derived terms used by
+ *            every sample
+ *    @param  ee Raw words EE_P_R_LSW..EE_KB
+ *    @param  ee_h Raw words EE_HA and EE_HB
+ */
+void Adafruit_MLX90632::applyCalibration(const uint16_t* ee,
+                                         const uint16_t* ee_h) {
+  deriveCalibration(ee, ee_h, &cal);
 
 #ifdef MLX90632_DEBUG
   // Debug: Print calibration constants
+  mlx90632_ee_constants_t c;
+  decodeCalibration(ee, ee_h, &c);
   Serial.println(F("Calibration constants:"));
   Serial.print(F("  P_R = "));
-  Serial.println(P_R, 8);
+  Serial.println(c.P_R, 8);
   Serial.print(F("  P_G = "));
-  Serial.println(P_G, 8);
+  Serial.println(c.P_G, 8);
   Serial.print(F("  P_T = "));
-  Serial.println(P_T, 12);
+  Serial.println(c.P_T, 12);
   Serial.print(F("  P_O = "));
-  Serial.println(P_O, 8);
+  Serial.println(c.P_O, 8);
   Serial.print(F("  Aa = "));
-  Serial.println(Aa, 8);
+  Serial.println(c.Aa, 8);
   Serial.print(F("  Ab = "));
-  Serial.println(Ab, 8);
+  Serial.println(c.Ab, 8);
   Serial.print(F("  Ba = "));
-  Serial.println(Ba, 8);
+  Serial.println(c.Ba, 8);
   Serial.print(F("  Bb = "));
-  Serial.println(Bb, 8);
+  Serial.println(c.Bb, 8);
   Serial.print(F("  Ca = "));
-  Serial.println(Ca, 8);
+  Serial.println(c.Ca, 8);
   Serial.print(F("  Cb = "));
-  Serial.println(Cb, 8);
+  Serial.println(c.Cb, 8);
   Serial.print(F("  Da = "));
-  Serial.println(Da, 8);
+  Serial.println(c.Da, 8);
   Serial.print(F("  Db = "));
-  Serial.println(Db, 8);
+  Serial.println(c.Db, 8);
   Serial.print(F("  Ea = "));
-  Serial.println(Ea, 8);
+  Serial.println(c.Ea, 8);
   Serial.print(F("  Eb = "));
-  Serial.println(Eb, 8);
+  Serial.println(c.Eb, 8);
   Serial.print(F("  Fa = "));
-  Serial.println(Fa, 12);
+  Serial.println(c.Fa, 12);
   Serial.print(F("  Fb = "));
-  Serial.println(Fb, 10);
+  Serial.println(c.Fb, 10);
   Serial.print(F("  Ga = "));
-  Serial.println(Ga, 10);
-  Serial.print(F("  Gb = "));
-  Serial.println(Gb, 8);
+  Serial.println(c.Ga, 10);
+  Serial.print(F("  Gb / 12 = "));
+  Serial.println(cal.Gb_12, 8);
   Serial.print(F("  Ka = "));
-  Serial.println(Ka, 8);
+  Serial.println(c.Ka, 8);
   Serial.print(F("  Kb = "));
-  Serial.println(Kb);
+  Serial.println(c.Kb);
   Serial.print(F("  Ha = "));
-  Serial.println(Ha, 8);
+  Serial.println(c.Ha, 8);
   Serial.print(F("  Hb = "));
-  Serial.println(Hb, 8);
+  Serial.println(c.Hb, 8);
 #endif
+}
+
+/*!
+ *    @brief  Read one raw RAM frame in a single burst. This is the only bus
+ *            access needed per sample; computeAmbient() and computeObject()
+ *            convert the frame without touching the bus.
+ *    @param  frame Frame to fill with the RAM window of the current
+ *            measurement type
+ *    @param  status Snapshot from readStatus() that gives the cycle
+ *            position. If nullptr (the default), medical frames read the
+ *            status register first.
+ *    @return True if all reads succeeded, false otherwise, including a
+ *            failed status read
+ */
+bool Adafruit_MLX90632::readFrame(mlx90632_frame_t* frame,
+                                  const mlx90632_status_t* status) {
+  frame->meas_select = getMeasurementSelect();
+  frame->cycle_position = 0;
+
+  // Medical mode: cycle position selects between RAM_4/5 and RAM_7/8
+  if (frame->meas_select == MLX90632_MEAS_MEDICAL) {
+    mlx90632_status_t read;
+
+    if (!status) {
+      // A failed read must not pass for cycle position 0
+      if (!readStatus(&read)) {
+        return false;
+      }
+      status = &read;
+    }
+    frame->cycle_position = status->cycle_position;
+  }
+  return readFrameRAM(frame);
+}
+
+/*!
+ *    @brief  Burst read the RAM window for a frame whose measurement type
+ *            and cycle position are already filled in
+ *    @param  frame Frame to fill
+ *    @return True if the read succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::readFrameRAM(mlx90632_frame_t* frame) {
+  if (frame->meas_select == MLX90632_MEAS_EXTENDED_RANGE) {
+    // Extended range mode: RAM_52-59
+    if (!readRegisters(MLX90632_REG_RAM_52, (uint16_t*)frame->ram, 8)) {
+      return false;
+    }
+    MLX90632_STAT(recordFrame(*frame));
+    return true;
+  }
+  // Medical mode: RAM_4-9
+  if (!readRegisters(MLX90632_REG_RAM_4, (uint16_t*)frame->ram, 6)) {
+    return false;
+  }
+  MLX90632_STAT(recordFrame(*frame));
+  return true;
+}
 
+/*!
+ *    @brief  Read the STATUS register, counting it as a status poll
+ *    @param  status Pointer to store the register value
+ *    @return True if the read succeeded, false otherwise
+ */
+bool Adafruit_MLX90632::readStatusWord(uint16_t* status) {
+  status_reads++;
+  return readRegisters(MLX90632_REG_STATUS, status, 1);
+}
+
+/*!
+ *    @brief  Read ambient and object temperature from the same frame
+ *    @param  ambient Pointer to store ambient temperature in degrees Celsius
+ *    @param  object Pointer to store object temperature in degrees Celsius,
+ *            NaN if the medical half-cycle is unknown, see computeObject()
+ *    @param  status Snapshot from readStatus(), see readFrame()
+ *    @return True if the frame read succeeded, false otherwise (both
+ *            temperatures are set to NaN)
+ */
+bool Adafruit_MLX90632::readTemperatures(double* ambient, double* object,
+                                         const mlx90632_status_t* status) {
+  mlx90632_frame_t frame;
+
+  if (!readFrame(&frame, status)) {
+    MLX90632_STAT(stats.nan_read_failed += 2);
+    *ambient = NAN;
+    *object = NAN;
+    return false;
+  }
+
+  *ambient = getAmbientTemperature(frame);
+  *object = getObjectTemperature(frame);
   return true;
 }
 
 /*!
  *    @brief  Calculate ambient temperature
- *    @return Ambient temperature in degrees Celsius
+ *    @return Ambient temperature in degrees Celsius or NaN if read failed
  */
 double Adafruit_MLX90632::getAmbientTemperature() {
-  // Check measurement mode to determine which RAM registers to use
-  mlx90632_meas_select_t meas_mode = getMeasurementSelect();
+  mlx90632_frame_t frame;
 
-  int16_t ram_ambient, ram_ref;
-
-  if (meas_mode == MLX90632_MEAS_EXTENDED_RANGE) {
-    // Extended range mode: use RAM_54 and RAM_57
-    Adafruit_BusIO_Register ram54_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_54), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram57_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_57), 2, MSBFIRST, 2);
+  if (!readFrame(&frame)) {
+    MLX90632_STAT(stats.nan_read_failed++);
+    return NAN;
+  }
+  return getAmbientTemperature(frame);
+}
 
-    ram_ambient = (int16_t)ram54_reg.read();
-    ram_ref = (int16_t)ram57_reg.read();
-  } else {
-    // Medical mode: use RAM_6 and RAM_9 (default)
-    Adafruit_BusIO_Register ram6_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_6), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram9_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_9), 2, MSBFIRST, 2);
+/*!
+ *    @brief  Calculate ambient temperature from a raw frame
+ *    @param  frame Frame previously filled by readFrame()
+ *    @return Ambient temperature in degrees Celsius
+ */
+double Adafruit_MLX90632::getAmbientTemperature(
+    const mlx90632_frame_t& frame) {
+  double ambient = computeAmbient(frame, cal);
 
-    ram_ambient = (int16_t)ram6_reg.read();
-    ram_ref = (int16_t)ram9_reg.read();
+#ifdef MLX90632_STATS
+  if (isnan(ambient)) {
+    stats.nan_math++;
   }
+#endif
+  return ambient;
+}
+
+/*!
+ *    @brief  Bus-free ambient temperature calculation, usable on stored
+ *            frames or on another host
+ *    @param  frame Raw frame
+ *    @param  cal Calibration terms from getCalibration()
+ *    @return Ambient temperature in degrees Celsius
+ */
+mlx90632_real_t Adafruit_MLX90632::computeAmbient(
+    const mlx90632_frame_t& frame, const mlx90632_calibration_t& cal) {
+  // RAM_6/RAM_9 (medical) and RAM_54/RAM_57 (extended) sit at the same offsets
+  int16_t ram_ambient = frame.ram[MLX90632_FRAME_AMBIENT];
+  int16_t ram_ref = frame.ram[MLX90632_FRAME_REF];
 
   // Pre-calculations for ambient temperature (same for both modes)
-  // Gb = EE_Gb * 2^-10 (already calculated in getCalibrations())
-  double VRTA = (double)ram_ref + Gb * ((double)ram_ambient / 12.0);
-  double AMB = ((double)ram_ambient / 12.0) / VRTA * (double)pow(2, 19);
+  // VRTA = ram_ref + Gb * (ram_ambient / 12)
+  // AMB = [ram_ambient/12]/VRTA * 2^19
+  mlx90632_real_t VRTA = ram_ref + cal.Gb_12 * ram_ambient;
+  mlx90632_real_t AMB = ram_ambient * MLX90632_AMB_SCALE / VRTA;
 
   // Calculate ambient temperature: P_O + (AMB - P_R)/P_G + P_T * (AMB - P_R)^2
-  double amb_diff = AMB - P_R;
-  double ambient_temp = P_O + (amb_diff / P_G) + P_T * (amb_diff * amb_diff);
+  mlx90632_real_t amb_diff = AMB - cal.P_R;
+  mlx90632_real_t ambient_temp =
+      cal.P_O + amb_diff * cal.inv_P_G + cal.P_T * (amb_diff * amb_diff);
 
 #ifdef MLX90632_DEBUG
   // Debug output
   Serial.print(F("  Mode = "));
-  Serial.println(meas_mode == MLX90632_MEAS_EXTENDED_RANGE ? F("Extended")
-                                                           : F("Medical"));
+  Serial.println(frame.meas_select == MLX90632_MEAS_EXTENDED_RANGE
+                     ? F("Extended")
+                     : F("Medical"));
   Serial.print(F("  RAM_ambient = "));
   Serial.println(ram_ambient);
   Serial.print(F("  RAM_ref = "));
   Serial.println(ram_ref);
-  Serial.print(F("  Gb = "));
-  Serial.println(Gb, 8);
+  Serial.print(F("  Gb / 12 = "));
+  Serial.println(cal.Gb_12, 8);
   Serial.print(F("  VRTA = "));
   Serial.println(VRTA, 8);
   Serial.print(F("  AMB = "));
@@ -507,125 +1248,183 @@ double Adafruit_MLX90632::getAmbientTemperature() {
 
 /*!
  *    @brief  Calculate object temperature
- *    @return Object temperature in degrees Celsius or NaN if invalid cycle
- * position
+ *    @return Object temperature in degrees Celsius or NaN if the medical
+ *            half-cycle is unknown or the read failed
  */
 double Adafruit_MLX90632::getObjectTemperature() {
-  // Check measurement mode to determine which calculation to use
-  mlx90632_meas_select_t meas_mode = getMeasurementSelect();
-
-  double S;
-  int16_t ram_ambient, ram_ref;
-
-  if (meas_mode == MLX90632_MEAS_EXTENDED_RANGE) {
-    // Extended range mode: use RAM_52-59
-    Adafruit_BusIO_Register ram52_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_52), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram53_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_53), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram54_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_54), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram55_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_55), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram56_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_56), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram57_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_57), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram58_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_58), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram59_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_59), 2, MSBFIRST, 2);
-
-    int16_t ram52 = (int16_t)ram52_reg.read();
-    int16_t ram53 = (int16_t)ram53_reg.read();
-    int16_t ram54 = (int16_t)ram54_reg.read();
-    int16_t ram55 = (int16_t)ram55_reg.read();
-    int16_t ram56 = (int16_t)ram56_reg.read();
-    int16_t ram57 = (int16_t)ram57_reg.read();
-    int16_t ram58 = (int16_t)ram58_reg.read();
-    int16_t ram59 = (int16_t)ram59_reg.read();
-
-    // Extended range S calculation
-    S = ((double)ram52 - (double)ram53 - (double)ram55 + (double)ram56) / 2.0 +
-        (double)ram58 + (double)ram59;
-    ram_ambient = ram54;
-    ram_ref = ram57;
+  mlx90632_frame_t frame;
 
-  } else {
-    // Medical mode: use cycle position and RAM_4-9
-    uint8_t cycle_pos = readCyclePosition();
-
-    Adafruit_BusIO_Register ram4_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_4), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram5_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_5), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram6_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_6), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram7_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_7), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram8_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_8), 2, MSBFIRST, 2);
-    Adafruit_BusIO_Register ram9_reg = Adafruit_BusIO_Register(
-        i2c_dev, swapBytes(MLX90632_REG_RAM_9), 2, MSBFIRST, 2);
-
-    int16_t ram4 = (int16_t)ram4_reg.read();
-    int16_t ram5 = (int16_t)ram5_reg.read();
-    int16_t ram6 = (int16_t)ram6_reg.read();
-    int16_t ram7 = (int16_t)ram7_reg.read();
-    int16_t ram8 = (int16_t)ram8_reg.read();
-    int16_t ram9 = (int16_t)ram9_reg.read();
-
-    // Medical mode S calculation based on cycle position
-    if (cycle_pos == 2) {
-      S = ((double)ram4 + (double)ram5) / 2.0;
-    } else if (cycle_pos == 1) {
-      S = ((double)ram7 + (double)ram8) / 2.0;
+  if (!readFrame(&frame)) {
+    MLX90632_STAT(stats.nan_read_failed++);
+    return NAN;
+  }
+  return getObjectTemperature(frame);
+}
+
+/*!
+ *    @brief  Calculate object temperature from a raw frame
+ *    @param  frame Frame just filled by readFrame(), taken to be captured
+ *            now
+ *    @return Object temperature in degrees Celsius or NaN if the medical
+ *            half-cycle is unknown
+ */
+double Adafruit_MLX90632::getObjectTemperature(const mlx90632_frame_t& frame) {
+  uint32_t now = millis();
+  mlx90632_mode_t mode = getMode();
+
+  // Step modes measure only when triggered, so no half can be missed
+  if (mode == MLX90632_MODE_STEP || mode == MLX90632_MODE_SLEEPING_STEP) {
+    now = solver.half_ms;
+  }
+  solver.period_ms = getRefreshPeriod();
+  double object = computeObject(frame, cal, &solver, &now);
+
+#ifdef MLX90632_STATS
+  if (isnan(object)) {
+    if (frame.meas_select == MLX90632_MEAS_MEDICAL &&
+        frame.cycle_position != 1 && frame.cycle_position != 2) {
+      stats.nan_cycle_position++;
     } else {
-      // Invalid cycle position - return NaN
-      return NAN;
+      stats.nan_math++;
     }
+  }
+#endif
+  return object;
+}
 
-    ram_ambient = ram6;
-    ram_ref = ram9;
+/*!
+ *    @brief  Get S of a medical frame from the half-cycle that was just
+ *            written. A cycle position other than 1 or 2, as seen e.g. in
+ *            step modes, is taken to be the half after the previous
+ *            sample's, since the two halves alternate. That only holds if
+ *            no sample was missed, so the previous sample must be less
+ *            than one and a half refresh periods older.
+ *    @param  frame Medical frame
+ *    @param  solver Half-cycle history, updated in place
+ *    @param  timestamp_ms Time the frame was captured, nullptr if unknown
+ *    @param  S Where to store S
+ *    @return False if the cycle position is invalid and the half can't be
+ *            inferred
+ */
+static bool medicalS(const mlx90632_frame_t& frame, mlx90632_solver_t* solver,
+                     const uint32_t* timestamp_ms, mlx90632_real_t* S) {
+  const int16_t* ram = frame.ram;
+  uint8_t half = frame.cycle_position;
+
+  if (half != 1 && half != 2) {
+    uint16_t period = solver->period_ms;
+    if (!solver->half || !timestamp_ms || !period ||
+        *timestamp_ms - solver->half_ms >= (uint32_t)period + period / 2) {
+      return false;
+    }
+    half = 3 - solver->half;
+  }
+  solver->half = half;
+  solver->halves |= 1 << (half - 1);
+  if (timestamp_ms) {
+    solver->half_ms = *timestamp_ms;
   }
 
+  if (solver->average_halves && solver->halves == 3) {
+    // Both halves hold a measurement: RAM_4/5 and RAM_7/8 averaged
+    *S = (mlx90632_real_t)((int32_t)ram[0] + ram[1] + ram[3] + ram[4]) / 4;
+  } else if (half == 2) {
+    // RAM_4/5
+    *S = (mlx90632_real_t)((int32_t)ram[0] + ram[1]) / 2;
+  } else {
+    // RAM_7/8
+    *S = (mlx90632_real_t)((int32_t)ram[3] + ram[4]) / 2;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Bus-free object temperature calculation, usable on stored
+ *            frames or on another host
+ *    @param  frame Raw frame
+ *    @param  cal Calibration terms from getCalibration()
+ *    @param  solver Solver settings and TO0/TA0 history, updated in place.
+ *            Frames must be passed in capture order for the history to match
+ *            what the driver would have computed live. It also tracks the
+ *            medical half-cycles, so a frame with an invalid cycle position
+ *            uses the half after the previous frame's if solver->period_ms
+ *            is set and the frames are timestamped.
+ *    @param  timestamp_ms Time the frame was captured in milliseconds, e.g.
+ *            from getLastSample(), or nullptr if unknown
+ *    @return Object temperature in degrees Celsius or NaN if the cycle
+ *            position is invalid and the half can't be inferred
+ */
+mlx90632_real_t Adafruit_MLX90632::computeObject(
+    const mlx90632_frame_t& frame, const mlx90632_calibration_t& cal,
+    mlx90632_solver_t* solver, const uint32_t* timestamp_ms) {
+  const int16_t* ram = frame.ram;
+  mlx90632_real_t S;
+
+  if (frame.meas_select == MLX90632_MEAS_EXTENDED_RANGE) {
+    // Extended range S calculation from RAM_52-59
+    S = (mlx90632_real_t)((int32_t)ram[0] - ram[1] - ram[3] + ram[4]) / 2 +
+        ram[6] + ram[7];
+  } else if (!medicalS(frame, solver, timestamp_ms, &S)) {
+    // No half-cycle to go on - return NaN
+    return NAN;
+  }
+
+  int16_t ram_ambient = ram[MLX90632_FRAME_AMBIENT];
+  int16_t ram_ref = ram[MLX90632_FRAME_REF];
+
   // Pre-calculations for object temperature (same for both modes)
   // VRTO = ram_ref + Ka * (ram_ambient / 12)
-  // Ka = EE_Ka * 2^-10 (already calculated in getCalibrations())
-  double VRTO = (double)ram_ref + Ka * ((double)ram_ambient / 12.0);
+  mlx90632_real_t VRTO = ram_ref + cal.Ka_12 * ram_ambient;
 
   // STO = [S/12]/VRTO * 2^19
-  double STO = ((S / 12.0) / VRTO) * (double)pow(2, 19);
+  mlx90632_real_t STO = S * MLX90632_AMB_SCALE / VRTO;
 
   // Calculate AMB for ambient temperature (needed for TADUT)
-  double VRTA = (double)ram_ref + Gb * ((double)ram_ambient / 12.0);
-  double AMB = ((double)ram_ambient / 12.0) / VRTA * (double)pow(2, 19);
+  mlx90632_real_t VRTA = ram_ref + cal.Gb_12 * ram_ambient;
+  mlx90632_real_t AMB = ram_ambient * MLX90632_AMB_SCALE / VRTA;
 
   // Additional temperature calculations
-  double TADUT = (AMB - Eb) / Ea + 25.0;
-  double TAK = TADUT + 273.15;
-  double emissivity = 1.0;
+  mlx90632_real_t TADUT = (AMB - cal.Eb) * cal.inv_Ea + 25;
+  mlx90632_real_t TAK = TADUT + MLX90632_KELVIN;
+
+  // Terms that stay the same on every solver iteration
+  mlx90632_real_t TAK4 = fourthPower(TAK);
+  mlx90632_real_t STO_FaHa = STO * cal.inv_emiss_FaHa;
+  mlx90632_real_t Fb_term = 1 + cal.Fb * (TADUT - solver->TA0);
 
-  // For the first iteration, use current TADUT as TODUT approximation
-  double TODUT = TADUT;
+  // A single pass uses the current TADUT as TODUT approximation, iterating
+  // warm-starts from the previous object temperature
+  mlx90632_real_t TODUT = (solver->max_iterations > 1) ? solver->TO0 : TADUT;
+  mlx90632_real_t denominator, TO_K4, TO;
 
   // Calculate final object temperature:
   // TO = pow( STO / (emiss * Fa * Ha * (1 + Ga * (TODUT - TO0) + Fb * (TADUT -
   // TA0))) + TAK^4, 0.25) - 273.15 - Hb
-  double denominator =
-      emissivity * Fa * Ha * (1.0 + Ga * (TODUT - TO0) + Fb * (TADUT - TA0));
-  double TAK4 = pow(TAK, 4);
-  double TO_K4 = (STO / denominator) + TAK4;
-  double TO = pow(TO_K4, 0.25) - 273.15 - Hb;
+  for (solver->iterations = 1;; solver->iterations++) {
+    denominator = Fb_term + cal.Ga * (TODUT - solver->TO0);
+    TO_K4 = (STO_FaHa / denominator) + TAK4;
+    TO = fourthRoot(TO_K4) - cal.Hb_K;
+
+    mlx90632_real_t delta = TO - TODUT;
+    if (delta < 0) {
+      delta = -delta;
+    }
+    if (solver->iterations >= solver->max_iterations ||
+        delta < solver->tolerance) {
+      break;
+    }
+    TODUT = TO;
+  }
 
 #ifdef MLX90632_DEBUG
   // Debug output
   Serial.print(F("  Mode = "));
-  Serial.println(meas_mode == MLX90632_MEAS_EXTENDED_RANGE ? F("Extended")
-                                                           : F("Medical"));
-  if (meas_mode == MLX90632_MEAS_MEDICAL) {
+  Serial.println(frame.meas_select == MLX90632_MEAS_EXTENDED_RANGE
+                     ? F("Extended")
+                     : F("Medical"));
+  if (frame.meas_select == MLX90632_MEAS_MEDICAL) {
     Serial.print(F("  Cycle Position = "));
-    Serial.println(readCyclePosition());
+    Serial.println(frame.cycle_position);
   }
   Serial.print(F("  RAM_ambient = "));
   Serial.println(ram_ambient);
@@ -633,8 +1432,8 @@ double Adafruit_MLX90632::getObjectTemperature() {
   Serial.println(ram_ref);
   Serial.print(F("  S = "));
   Serial.println(S, 8);
-  Serial.print(F("  Ka = "));
-  Serial.println(Ka, 8);
+  Serial.print(F("  Ka / 12 = "));
+  Serial.println(cal.Ka_12, 8);
   Serial.print(F("  VRTO = "));
   Serial.println(VRTO, 8);
   Serial.print(F("  STO = "));
@@ -660,11 +1459,9 @@ double Adafruit_MLX90632::getObjectTemperature() {
     Serial.println(TAK4, 2);
   }
   Serial.print(F("  TO0 = "));
-  Serial.println(TO0, 8);
+  Serial.println(solver->TO0, 8);
   Serial.print(F("  TA0 = "));
-  Serial.println(TA0, 8);
-  Serial.print(F("  Emissivity = "));
-  Serial.println(emissivity, 8);
+  Serial.println(solver->TA0, 8);
   Serial.print(F("  Denominator = "));
   Serial.println(denominator, 8);
   Serial.print(F("  TO_K^4 = "));
@@ -679,20 +1476,683 @@ double Adafruit_MLX90632::getObjectTemperature() {
   }
   Serial.print(F("  TO = "));
   Serial.println(TO, 8);
+  Serial.print(F("  Solver iterations = "));
+  Serial.println(solver->iterations);
 #endif
 
   // Update TO0 and TA0 with current measurements for next calculation
-  TO0 = TO;    // Use calculated object temperature
-  TA0 = TADUT; // Update with current ambient temperature calculation
+  solver->TO0 = TO;    // Use calculated object temperature
+  solver->TA0 = TADUT; // Update with current ambient temperature calculation
 
   return TO;
 }
 
 /*!
- *    @brief  Byte swap helper for register addresses
- *    @param  value 16-bit value to swap
- *    @return Byte-swapped value
+ *    @brief  Convert an array of raw frames to ambient and object
+ *            temperatures in one call. Gives the same results as calling
+ *            computeAmbient() and computeObject() on each frame in order.
+ *    @param  frames Raw frames in capture order
+ *    @param  count Number of frames
+ *    @param  cal Calibration terms from getCalibration()
+ *    @param  solver Solver settings and TO0/TA0 history, updated in place
+ *    @param  ambient Array of count ambient temperatures to fill
+ *    @param  object Array of count object temperatures to fill, NaN for
+ *            frames whose medical half-cycle is unknown
+ *    @param  timestamps_ms Capture times of the frames in milliseconds, or
+ *            nullptr if unknown
+ */
+void Adafruit_MLX90632::computeBatch(const mlx90632_frame_t* frames,
+                                     size_t count,
+                                     const mlx90632_calibration_t& cal,
+                                     mlx90632_solver_t* solver,
+                                     mlx90632_real_t* ambient,
+                                     mlx90632_real_t* object,
+                                     const uint32_t* timestamps_ms) {
+  // Structure-of-arrays block; each array is reused in place by the passes
+  mlx90632_real_t S[MLX90632_BATCH_BLOCK];   // S, then STO / (emiss*Fa*Ha)
+  mlx90632_real_t amb[MLX90632_BATCH_BLOCK]; // RAM ambient, then TADUT
+  mlx90632_real_t ref[MLX90632_BATCH_BLOCK]; // RAM reference, then TAK^4
+  bool valid[MLX90632_BATCH_BLOCK];
+
+  while (count > 0) {
+    size_t n = count < MLX90632_BATCH_BLOCK ? count : MLX90632_BATCH_BLOCK;
+
+    // Pass 1: gather the mode dependent S and the shared RAM words
+    for (size_t i = 0; i < n; i++) {
+      const int16_t* ram = frames[i].ram;
+
+      valid[i] = true;
+      if (frames[i].meas_select == MLX90632_MEAS_EXTENDED_RANGE) {
+        int32_t diff = (int32_t)ram[0] - ram[1] - ram[3] + ram[4];
+        S[i] = (mlx90632_real_t)diff / 2 + ram[6] + ram[7];
+      } else if (!medicalS(frames[i], solver,
+                           timestamps_ms ? &timestamps_ms[i] : nullptr,
+                           &S[i])) {
+        S[i] = 0;
+        valid[i] = false;
+      }
+      amb[i] = ram[MLX90632_FRAME_AMBIENT];
+      ref[i] = ram[MLX90632_FRAME_REF];
+    }
+
+    // Pass 2: everything that doesn't depend on the previous sample.
+    // Straight-line arithmetic, so the compiler can vectorize it.
+    for (size_t i = 0; i < n; i++) {
+      mlx90632_real_t VRTO = ref[i] + cal.Ka_12 * amb[i];
+      mlx90632_real_t STO = S[i] * MLX90632_AMB_SCALE / VRTO;
+      mlx90632_real_t VRTA = ref[i] + cal.Gb_12 * amb[i];
+      mlx90632_real_t AMB = amb[i] * MLX90632_AMB_SCALE / VRTA;
+      mlx90632_real_t amb_diff = AMB - cal.P_R;
+      mlx90632_real_t TADUT = (AMB - cal.Eb) * cal.inv_Ea + 25;
+
+      ambient[i] =
+          cal.P_O + amb_diff * cal.inv_P_G + cal.P_T * (amb_diff * amb_diff);
+      S[i] = STO * cal.inv_emiss_FaHa;
+      amb[i] = TADUT;
+      ref[i] = fourthPower(TADUT + MLX90632_KELVIN);
+    }
+
+    // Pass 3: the TO0/TA0 recurrence, one sample after the other. The
+    // history is kept in locals so the dependency chain stays in registers.
+    mlx90632_real_t TO0 = solver->TO0;
+    mlx90632_real_t TA0 = solver->TA0;
+    uint8_t iterations = solver->iterations;
+
+    for (size_t i = 0; i < n; i++) {
+      if (!valid[i]) {
+        object[i] = NAN;
+        continue;
+      }
+
+      mlx90632_real_t TADUT = amb[i];
+      mlx90632_real_t Fb_term = 1 + cal.Fb * (TADUT - TA0);
+      mlx90632_real_t TODUT = (solver->max_iterations > 1) ? TO0 : TADUT;
+      mlx90632_real_t TO;
+
+      for (iterations = 1;; iterations++) {
+        mlx90632_real_t denominator = Fb_term + cal.Ga * (TODUT - TO0);
+        TO = fourthRoot((S[i] / denominator) + ref[i]) - cal.Hb_K;
+
+        mlx90632_real_t delta = TO - TODUT;
+        if (delta < 0) {
+          delta = -delta;
+        }
+        if (iterations >= solver->max_iterations ||
+            delta < solver->tolerance) {
+          break;
+        }
+        TODUT = TO;
+      }
+
+      object[i] = TO;
+      TO0 = TO;
+      TA0 = TADUT;
+    }
+
+    solver->TO0 = TO0;
+    solver->TA0 = TA0;
+    solver->iterations = iterations;
+
+    frames += n;
+    ambient += n;
+    object += n;
+    if (timestamps_ms) {
+      timestamps_ms += n;
+    }
+    count -= n;
+  }
+}
+
+/*!
+ *    @brief  Get the time between measurements at the current refresh rate
+ *    @return Refresh period in milliseconds
+ */
+uint16_t Adafruit_MLX90632::getRefreshPeriod() {
+  // 0.5 Hz (2000 ms) halves with each refresh rate step
+  return 2000 >> getRefreshRate();
+}
+
+/*!
+ *    @brief  Advance the non-blocking measurement state machine. Call this
+ *            often from loop(); it only touches the bus when a status check
+ *            or frame read is due, so it never spins on the status register.
+ *            In step and sleeping step modes it triggers each measurement,
+ *            in continuous mode it waits for the next one.
+ *    @return The new state. MLX90632_STATE_READY is returned once per
+ *            sample, after which the results are available from
+ *            getLastFrame(), getLastAmbientTemperature() and
+ *            getLastObjectTemperature().
+ */
+mlx90632_poll_state_t Adafruit_MLX90632::poll() {
+  uint32_t now = millis();
+  uint16_t period;
+  mlx90632_status_t status;
+
+  // Nothing is due yet
+  if ((int32_t)(now - poll_next_ms) < 0) {
+    return poll_state;
+  }
+
+  switch (poll_state) {
+    case MLX90632_STATE_IDLE:
+    case MLX90632_STATE_READY:
+      if (resync_pending) {
+        if (!resync()) {
+          return poll_state;
+        }
+        resync_pending = false;
+      }
+
+      period = getRefreshPeriod();
+      switch (getMode()) {
+        case MLX90632_MODE_STEP:
+        case MLX90632_MODE_SLEEPING_STEP:
+          if (!startSingleMeasurement()) {
+            return poll_state;
+          }
+          data_ready_flag = false;
+          // Data can't be ready before one refresh period has passed
+          poll_state = MLX90632_STATE_TRIGGERED;
+          poll_next_ms = now + period;
+          break;
+        case MLX90632_MODE_CONTINUOUS:
+          // The next sample is one period after the last one, unless the
+          // host tells us when it is ready
+          if (poll_state == MLX90632_STATE_READY && !data_ready_notify) {
+            poll_next_ms = now + period - period / 8;
+          }
+          poll_state = MLX90632_STATE_WAITING;
+          break;
+        default:
+          // Halted, nothing to measure
+          poll_state = MLX90632_STATE_IDLE;
+          break;
+      }
+      return poll_state;
+
+    case MLX90632_STATE_TRIGGERED:
+    case MLX90632_STATE_WAITING:
+      poll_state = MLX90632_STATE_WAITING;
+      // Data was ready at the latest when this status read starts
+      MLX90632_STAT(stats_ready_us = micros());
+      if (data_ready_notify) {
+        // Don't touch the bus until the host says data is ready
+        if (!data_ready_flag) {
+          return poll_state;
+        }
+        MLX90632_STAT(stats_ready_us = stats_notify_us);
+      }
+
+      // One status read confirms new_data and gives the cycle position
+      if (!readStatus(&status) || !status.new_data) {
+        // Check once, then back off by an eighth of the refresh period. An
+        // early notification stays pending, so the check is repeated.
+        period = getRefreshPeriod() / 8;
+        poll_next_ms = now + (period ? period : 1);
+        return poll_state;
+      }
+      data_ready_flag = false;
+      poll_status = status.raw;
+      poll_frame.meas_select = getMeasurementSelect();
+      poll_frame.cycle_position = status.cycle_position;
+      poll_state = MLX90632_STATE_READING;
+      return poll_state;
+
+    case MLX90632_STATE_READING:
+      // Clear new_data from the status already read, no second status read
+      if (!readFrameRAM(&poll_frame) ||
+          !writeRegister(mlx90632_status_new_data_t::address(),
+                         mlx90632_status_new_data_t::set(poll_status, 0))) {
+        // Try again after an eighth of the refresh period, so a missing
+        // sensor doesn't get a burst on every call
+        period = getRefreshPeriod() / 8;
+        poll_next_ms = now + (period ? period : 1);
+        return poll_state;
+      }
+      MLX90632_STAT(recordLatency(micros() - stats_ready_us));
+      poll_ambient = getAmbientTemperature(poll_frame);
+      poll_object = getObjectTemperature(poll_frame);
+      poll_ready_ms = now;
+      poll_state = MLX90632_STATE_READY;
+      return poll_state;
+  }
+
+  return poll_state;
+}
+
+/*!
+ *    @brief  Get the last completed poll() sample as a timestamped record,
+ *            e.g. to push into an Adafruit_MLX90632_SampleRing
+ *    @param  sample Record to fill
+ */
+void Adafruit_MLX90632::getLastSample(mlx90632_sample_t* sample) {
+  sample->timestamp_ms = poll_ready_ms;
+  sample->status = poll_status;
+  sample->frame = poll_frame;
+  sample->ambient = (mlx90632_real_t)poll_ambient;
+  sample->object = (mlx90632_real_t)poll_object;
+}
+
+/*!
+ *    @brief  Enable or disable data-ready notification. When enabled,
+ *            poll() does not read the status register while waiting for a
+ *            sample; the host calls notifyDataReady() instead, e.g. from a
+ *            timer aligned to the refresh period.
+ *    @param  enable True to wait for notifyDataReady(), false to poll the
+ *            status register
+ */
+void Adafruit_MLX90632::setDataReadyNotify(bool enable) {
+  data_ready_notify = enable;
+  data_ready_flag = false;
+}
+
+/*!
+ *    @brief  Tell the driver that new data should be available. Safe to call
+ *            from an interrupt; the bus is only accessed by the next poll().
+ *            If the notification came early and the status shows no new
+ *            data yet, poll() keeps checking every eighth of the refresh
+ *            period until it does.
+ */
+void Adafruit_MLX90632::notifyDataReady() {
+  MLX90632_STAT(stats_notify_us = micros());
+  data_ready_flag = true;
+}
+
+/*!
+ *    @brief  Start reading a sample as a chain of three descriptors (status
+ *            read, RAM burst, new_data clear) handed to the transport's
+ *            submit(). A DMA- or interrupt-driven transport returns at once
+ *            and runs the chain in the background. When the chain ends, the
+ *            temperatures are computed in the transport's completion
+ *            context and callback is called; the sample is then also
+ *            available from getLastSample() and the getLast...() methods.
+ *            On the blocking Wire and Linux transports the whole chain,
+ *            callback included, runs before this returns. Don't call poll()
+ *            or other register methods while a chain is in flight.
+ *    @param  callback Called once when the chain ends
+ *    @param  context Passed to callback
+ *    @return True if the chain was started, false if one is already in
+ *            flight, callback is nullptr or the transport refused it
+ */
+bool Adafruit_MLX90632::readFrameAsync(mlx90632_async_callback_t callback,
+                                       void* context) {
+  mlx90632_frame_t& frame = async_sample.frame;
+
+  if (async_busy || !callback ||
+      transport.maxBufferSize() < sizeof(async_rx)) {
+    return false;
+  }
+
+  frame.meas_select = getMeasurementSelect();
+  frame.cycle_position = 0;
+  bool medical = frame.meas_select == MLX90632_MEAS_MEDICAL;
+  initXfer(&async_xfer[0], MLX90632_REG_STATUS, async_rx, 2, asyncStatusDone,
+           this, &async_xfer[1]);
+  initXfer(&async_xfer[1], medical ? MLX90632_REG_RAM_4 : MLX90632_REG_RAM_52,
+           async_rx, medical ? 2 * 6 : 2 * 8, asyncRAMDone, this,
+           &async_xfer[2]);
+  // The value is filled in from the status read
+  initXfer(&async_xfer[2], mlx90632_status_new_data_t::address(), nullptr, 0,
+           asyncClearDone, this, nullptr);
+
+  async_callback = callback;
+  async_context = context;
+  async_busy = true;
+  if (!transport.submit(&async_xfer[0])) {
+    async_busy = false;
+    return false;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Check whether a readFrameAsync() chain is in flight
+ *    @return True until the chain's callback is called
+ */
+bool Adafruit_MLX90632::isAsyncBusy() {
+  return async_busy;
+}
+
+/*!
+ *    @brief  Count a transaction of the asynchronous chain
+ *    @param  xfer Descriptor that just completed
+ *    @return True if the transaction succeeded
+ */
+bool Adafruit_MLX90632::asyncTransaction(mlx90632_xfer_t* xfer) {
+  transactions++;
+  MLX90632_STAT(stats.transactions++);
+  if (trace) {
+    uint16_t reg = ((uint16_t)xfer->tx[0] << 8) | xfer->tx[1];
+
+    if (xfer->rx_len) {
+      trace->record(true, xfer->ok, reg, xfer->rx, xfer->rx_len);
+    } else {
+      trace->record(false, xfer->ok, reg, xfer->tx + 2, 2);
+    }
+  }
+  if (!xfer->ok) {
+#ifdef MLX90632_STATS
+    if (xfer->rx_len) {
+      stats.failed_reads++;
+    } else {
+      stats.failed_writes++;
+    }
+#endif
+    finishAsync(MLX90632_ASYNC_FAILED);
+    return false;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Completion of the status read: stop the chain if there is no
+ *            new data, otherwise prepare the write that clears new_data
+ *    @param  xfer The status read descriptor
+ *    @return True to go on with the RAM burst
+ */
+bool Adafruit_MLX90632::asyncStatusDone(mlx90632_xfer_t* xfer) {
+  Adafruit_MLX90632* self = static_cast<Adafruit_MLX90632*>(xfer->context);
+  mlx90632_status_t status;
+
+  self->status_reads++;
+  if (!self->asyncTransaction(xfer)) {
+    return false;
+  }
+  decodeStatus(((uint16_t)xfer->rx[0] << 8) | xfer->rx[1], &status);
+  if (!status.new_data) {
+    self->finishAsync(MLX90632_ASYNC_NO_DATA);
+    return false;
+  }
+
+  self->async_sample.status = status.raw;
+  if (self->async_sample.frame.meas_select == MLX90632_MEAS_MEDICAL) {
+    self->async_sample.frame.cycle_position = status.cycle_position;
+  }
+  uint16_t clear = mlx90632_status_new_data_t::set(status.raw, 0);
+  self->async_xfer[2].tx[2] = (uint8_t)(clear >> 8);
+  self->async_xfer[2].tx[3] = (uint8_t)(clear & 0xFF);
+  return true;
+}
+
+/*!
+ *    @brief  Completion of the RAM burst: unpack the big-endian words
+ *    @param  xfer The RAM read descriptor
+ *    @return True to go on with the new_data clear
+ */
+bool Adafruit_MLX90632::asyncRAMDone(mlx90632_xfer_t* xfer) {
+  Adafruit_MLX90632* self = static_cast<Adafruit_MLX90632*>(xfer->context);
+  int16_t* ram = self->async_sample.frame.ram;
+
+  if (!self->asyncTransaction(xfer)) {
+    return false;
+  }
+  for (uint8_t i = 0; i < xfer->rx_len / 2; i++) {
+    ram[i] = (int16_t)(((uint16_t)xfer->rx[2 * i] << 8) | xfer->rx[2 * i + 1]);
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Completion of the new_data clear, the end of the chain
+ *    @param  xfer The write descriptor
+ *    @return False, nothing follows
+ */
+bool Adafruit_MLX90632::asyncClearDone(mlx90632_xfer_t* xfer) {
+  Adafruit_MLX90632* self = static_cast<Adafruit_MLX90632*>(xfer->context);
+
+  if (self->asyncTransaction(xfer)) {
+    self->finishAsync(MLX90632_ASYNC_DONE);
+  }
+  return false;
+}
+
+/*!
+ *    @brief  End the asynchronous chain: compute the temperatures of a
+ *            complete frame, publish it as the last sample and call the
+ *            callback
+ *    @param  result How the chain ended
+ */
+void Adafruit_MLX90632::finishAsync(mlx90632_async_result_t result) {
+  mlx90632_async_callback_t callback = async_callback;
+
+  if (result == MLX90632_ASYNC_DONE) {
+    mlx90632_sample_t& sample = async_sample;
+
+    MLX90632_STAT(recordFrame(sample.frame));
+    poll_ambient = getAmbientTemperature(sample.frame);
+    poll_object = getObjectTemperature(sample.frame);
+    poll_ready_ms = millis();
+    poll_status = sample.status;
+    poll_frame = sample.frame;
+    getLastSample(&sample);
+  }
+  // The callback may start the next chain
+  async_busy = false;
+  callback(async_context, result, &async_sample);
+}
+
+/*!
+ *    @brief  Get the current state of the non-blocking state machine
+ *    @return Current state
+ */
+mlx90632_poll_state_t Adafruit_MLX90632::getPollState() {
+  return poll_state;
+}
+
+/*!
+ *    @brief  Get the time poll() next has work to do
+ *    @return millis() value at which poll() should next be called
+ */
+uint32_t Adafruit_MLX90632::getNextPollTime() {
+  return poll_next_ms;
+}
+
+/*!
+ *    @brief  Get the frame read by the last completed poll() sample
+ *    @return Reference to the last frame
+ */
+const mlx90632_frame_t& Adafruit_MLX90632::getLastFrame() {
+  return poll_frame;
+}
+
+/*!
+ *    @brief  Get the ambient temperature of the last completed poll() sample
+ *    @return Ambient temperature in degrees Celsius
+ */
+double Adafruit_MLX90632::getLastAmbientTemperature() {
+  return poll_ambient;
+}
+
+/*!
+ *    @brief  Get the object temperature of the last completed poll() sample
+ *    @return Object temperature in degrees Celsius, NaN if the medical
+ *            half-cycle is unknown or no sample yet
+ */
+double Adafruit_MLX90632::getLastObjectTemperature() {
+  return poll_object;
+}
+
+/*!
+ *    @brief  Set solver defaults: a single pass, 0.01 degree tolerance and
+ *            TO0 = TA0 = 25 degrees Celsius
+ *    @param  solver Solver state to initialize
+ */
+void Adafruit_MLX90632::initSolver(mlx90632_solver_t* solver) {
+  solver->TO0 = 25; // Initialize previous object temperature
+  solver->TA0 = 25; // Initialize previous ambient temperature
+  solver->max_iterations = 1;
+  solver->tolerance = (mlx90632_real_t)0.01;
+  solver->iterations = 0;
+  solver->half = 0;
+  solver->halves = 0;
+  solver->average_halves = false;
+  solver->period_ms = 0;
+  solver->half_ms = 0;
+}
+
+/*!
+ *    @brief  Get the calibration terms, e.g. to convert stored frames with
+ *            computeAmbient() / computeObject() later or on another host
+ *    @return Reference to the calibration terms loaded by getCalibrations()
+ */
+const mlx90632_calibration_t& Adafruit_MLX90632::getCalibration() {
+  return cal;
+}
+
+/*!
+ *    @brief  Get the solver settings and TO0/TA0 history of the driver
+ *    @return Reference to the solver state
+ */
+const mlx90632_solver_t& Adafruit_MLX90632::getSolverState() {
+  return solver;
+}
+
+/*!
+ *    @brief  Configure the object temperature solver
+ *    @param  max_iterations Maximum number of TODUT iterations per sample.
+ *            1 (the default) is a single pass with TODUT = TADUT. Larger
+ *            values warm-start from the previous object temperature and
+ *            iterate until the result converges.
+ *    @param  tolerance Stop iterating once the object temperature changes by
+ *            less than this many degrees Celsius
+ *    @return True if the settings are valid, false otherwise
+ */
+bool Adafruit_MLX90632::setSolver(uint8_t max_iterations, double tolerance) {
+  if (max_iterations == 0 || tolerance < 0) {
+    return false;
+  }
+  solver.max_iterations = max_iterations;
+  solver.tolerance = (mlx90632_real_t)tolerance;
+  return true;
+}
+
+/*!
+ *    @brief  Get the number of solver iterations used by the last object
+ *            temperature calculation
+ *    @return Number of iterations, 0 if no object temperature was calculated
+ */
+uint8_t Adafruit_MLX90632::getSolverIterations() {
+  return solver.iterations;
+}
+
+/*!
+ *    @brief  Choose the medical object output. Each medical frame holds
+ *            both half-cycles, the one just written and the one before.
+ *            By default the object temperature comes from the new half
+ *            only; averaging uses both, for less noise at the same output
+ *            rate and a little more lag, as one half is a half-cycle older.
+ *            Until both halves have been written the new half is used
+ *            alone.
+ *    @param  enable True to average both halves, false for the new half
+ */
+void Adafruit_MLX90632::setHalfCycleAveraging(bool enable) {
+  solver.average_halves = enable;
+}
+
+/*!
+ *    @brief  Get the medical half-cycle the last object temperature came
+ *            from. It follows the cycle position, or the alternation of the
+ *            halves when the cycle position was invalid.
+ *    @return 2 for RAM_4/5, 1 for RAM_7/8, 0 if there was none yet
+ */
+uint8_t Adafruit_MLX90632::getLastHalfCycle() {
+  return solver.half;
+}
+
+/*!
+ *    @brief  Record every register transaction from now on, e.g. to replay
+ *            a field unit's exact status, cycle position and RAM sequence
+ *            later with Adafruit_MLX90632_TraceReplay. Attach it before
+ *            begin() so the trace holds the calibration reads as well.
+ *    @param  recorder Recorder, begun, or nullptr to stop recording
+ */
+void Adafruit_MLX90632::setTrace(Adafruit_MLX90632_TraceRecorder* recorder) {
+  trace = recorder;
+}
+
+/*!
+ *    @brief  Get the number of register transactions issued on the bus
+ *    @return Number of transactions since begin() or the last reset
+ */
+uint32_t Adafruit_MLX90632::getTransactionCount() {
+  return transactions;
+}
+
+/*!
+ *    @brief  Reset the bus transaction and status read counters to zero
+ */
+void Adafruit_MLX90632::resetTransactionCount() {
+  transactions = 0;
+  status_reads = 0;
+}
+
+/*!
+ *    @brief  Get the number of status register reads, a subset of
+ *            getTransactionCount() that shows the polling traffic
+ *    @return Number of status reads since begin() or the last reset
+ */
+uint32_t Adafruit_MLX90632::getStatusReadCount() {
+  return status_reads;
+}
+
+/*!
+ *    @brief  Get the number of transactions the last getCalibrations() saved
+ *            compared to reading each calibration word individually
+ *    @return Number of transactions saved
+ */
+uint16_t Adafruit_MLX90632::getCalibrationTransactionsSaved() {
+  return cal_transactions_saved;
+}
+
+#ifdef MLX90632_STATS
+/*!
+ *    @brief  Get the driver counters (only with MLX90632_STATS)
+ *    @return Reference to the counters since construction or resetStats()
  */
-uint16_t Adafruit_MLX90632::swapBytes(uint16_t value) {
-  return (value << 8) | (value >> 8);
+const mlx90632_stats_t& Adafruit_MLX90632::getStats() {
+  return stats;
 }
+
+/*!
+ *    @brief  Reset the driver counters to zero (only with MLX90632_STATS)
+ */
+void Adafruit_MLX90632::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+  stats.latency_min_us = UINT32_MAX;
+}
+
+/*!
+ *    @brief  Count a frame read, and its cycle position in medical mode
+ *    @param  frame Frame just read
+ */
+void Adafruit_MLX90632::recordFrame(const mlx90632_frame_t& frame) {
+  stats.frames++;
+  if (frame.meas_select == MLX90632_MEAS_MEDICAL) {
+    stats.cycle_position[frame.cycle_position < 3 ? frame.cycle_position
+                                                  : 3]++;
+  }
+}
+
+/*!
+ *    @brief  Add a data-ready to read-complete time to the counters
+ *    @param  latency_us Latency in microseconds
+ */
+void Adafruit_MLX90632::recordLatency(uint32_t latency_us) {
+  uint8_t bucket = 0;
+
+  while (bucket < MLX90632_STATS_BUCKETS - 1 &&
+         latency_us >= ((uint32_t)MLX90632_STATS_BUCKET_US << bucket)) {
+    bucket++;
+  }
+  stats.latency_histogram[bucket]++;
+  stats.latency_count++;
+  stats.latency_last_us = latency_us;
+  stats.latency_total_us += latency_us;
+  if (latency_us < stats.latency_min_us) {
+    stats.latency_min_us = latency_us;
+  }
+  if (latency_us > stats.latency_max_us) {
+    stats.latency_max_us = latency_us;
+  }
+}
+#endif
@@ -18,16 +18,16 @@
 #ifndef _ADAFRUIT_MLX90632_H
 #define _ADAFRUIT_MLX90632_H
 
-#include <Adafruit_BusIO_Register.h>
-#include <Adafruit_I2CDevice.h>
-#include <Wire.h>
-
+#include "Adafruit_MLX90632_Trace.h"
+#include "Adafruit_MLX90632_Transport.h"
 #include "Arduino.h"
 
 /*=========================================================================
     I2C ADDRESS/BITS
     -----------------------------------------------------------------------*/
 #define MLX90632_DEFAULT_ADDR 0x3A ///< MLX90632 default i2c address
+#define MLX90632_MAX_BURST_WORDS \
+  32 ///< Upper limit of 16-bit words read in one bus transaction
 /*=========================================================================*/
 
 /*=========================================================================
@@ -117,6 +117,10 @@
 #define MLX90632_REG_EE_GB 0x242E ///< Gb calibration constant (16-bit)
 #define MLX90632_REG_EE_KA 0x242F ///< Ka calibration constant (16-bit)
 #define MLX90632_REG_EE_KB 0x2430 ///< Kb calibration constant (16-bit)
+#define MLX90632_CAL_BLOCK_WORDS \
+  37 ///< Number of contiguous calibration words from P_R_LSW to Kb
+#define MLX90632_ID_BLOCK_WORDS \
+  7 ///< Number of contiguous words from ID0 to EE_VERSION
 #define MLX90632_REG_MELEXIS_RESERVED49 0x2431  ///< Melexis reserved
 #define MLX90632_REG_MELEXIS_RESERVED127 0x247F ///< Melexis reserved
 #define MLX90632_REG_MELEXIS_RESERVED128 0x2480 ///< Melexis reserved
@@ -132,11 +136,17 @@
 #define MLX90632_REG_MELEXIS_RESERVED214 0x24D6 ///< Melexis reserved
 #define MLX90632_REG_EE_MEAS_1 0x24E1           ///< Measurement settings 1
 #define MLX90632_REG_EE_MEAS_2 0x24E2           ///< Measurement settings 2
+#define MLX90632_REG_EE_LAST 0x24FF             ///< Last EEPROM address
 
 // Control and Status registers
 #define MLX90632_REG_I2C_ADDRESS 0x3000 ///< I2C slave address >> 1
 #define MLX90632_REG_CONTROL 0x3001     ///< Control register, measurement mode
 #define MLX90632_REG_STATUS 0x3FFF      ///< Status register: data available
+#define MLX90632_REG_I2C_COMMAND 0x3005 ///< Addressed reset / EEPROM unlock
+
+// Commands written to MLX90632_REG_I2C_COMMAND
+#define MLX90632_CMD_RESET 0x0006     ///< Addressed reset
+#define MLX90632_CMD_EE_UNLOCK 0x554C ///< Unlock the next EEPROM erase/write
 
 // RAM addresses
 #define MLX90632_REG_RAM_1 0x4000  ///< Raw data 1
@@ -195,6 +205,297 @@ typedef enum {
 } mlx90632_refresh_rate_t;
 /*=========================================================================*/
 
+/*=========================================================================
+    REGISTER FIELDS
+    -----------------------------------------------------------------------*/
+/*!
+ *    @brief  Compile-time descriptor of a bit field in a 16-bit register.
+ *            Everything is a constant, so a field access is one raw
+ *            register transfer plus a shift and mask.
+ *    @tparam ADDR Register address
+ *    @tparam SHIFT Position of the lowest bit of the field
+ *    @tparam WIDTH Number of bits in the field
+ */
+template <uint16_t ADDR, uint8_t SHIFT, uint8_t WIDTH>
+struct Adafruit_MLX90632_Field {
+  /*!
+   *    @brief  Register address
+   *    @return ADDR
+   */
+  static constexpr uint16_t address() { return ADDR; }
+  /*!
+   *    @brief  Field bits within the register
+   *    @return Mask of the field
+   */
+  static constexpr uint16_t mask() {
+    return (uint16_t)(((1UL << WIDTH) - 1) << SHIFT);
+  }
+  /*!
+   *    @brief  Extract the field from a register value
+   *    @param  reg Register value
+   *    @return Field value
+   */
+  static constexpr uint16_t get(uint16_t reg) {
+    return (uint16_t)((reg & mask()) >> SHIFT);
+  }
+  /*!
+   *    @brief  Replace the field in a register value
+   *    @param  reg Register value
+   *    @param  value New field value, extra bits are dropped
+   *    @return Register value with the field replaced
+   */
+  static constexpr uint16_t set(uint16_t reg, uint16_t value) {
+    return (uint16_t)((reg & ~mask()) | (((uint32_t)value << SHIFT) & mask()));
+  }
+};
+
+typedef Adafruit_MLX90632_Field<MLX90632_REG_ID0, 0, 16>
+    mlx90632_id0_t; ///< Chip ID, least significant word
+typedef Adafruit_MLX90632_Field<MLX90632_REG_EE_PRODUCT_CODE, 0, 16>
+    mlx90632_ee_product_code_t; ///< Product code
+typedef Adafruit_MLX90632_Field<MLX90632_REG_EE_VERSION, 0, 16>
+    mlx90632_ee_version_t; ///< EEPROM version
+typedef Adafruit_MLX90632_Field<MLX90632_REG_EE_MEAS_1, 8, 3>
+    mlx90632_ee_meas1_refresh_t; ///< EE_MEAS_1 refresh rate
+typedef Adafruit_MLX90632_Field<MLX90632_REG_EE_MEAS_2, 8, 3>
+    mlx90632_ee_meas2_refresh_t; ///< EE_MEAS_2 refresh rate
+typedef Adafruit_MLX90632_Field<MLX90632_REG_CONTROL, 1, 2>
+    mlx90632_control_mode_t; ///< CONTROL measurement mode
+typedef Adafruit_MLX90632_Field<MLX90632_REG_CONTROL, 3, 1>
+    mlx90632_control_soc_t; ///< CONTROL start of conversion, self-clearing
+typedef Adafruit_MLX90632_Field<MLX90632_REG_CONTROL, 4, 5>
+    mlx90632_control_meas_select_t; ///< CONTROL measurement type
+typedef Adafruit_MLX90632_Field<MLX90632_REG_CONTROL, 11, 1>
+    mlx90632_control_sob_t; ///< CONTROL start of burst, self-clearing
+typedef Adafruit_MLX90632_Field<MLX90632_REG_STATUS, 0, 1>
+    mlx90632_status_new_data_t; ///< STATUS new data available
+typedef Adafruit_MLX90632_Field<MLX90632_REG_STATUS, 2, 5>
+    mlx90632_status_cycle_position_t; ///< STATUS cycle position
+typedef Adafruit_MLX90632_Field<MLX90632_REG_STATUS, 8, 1>
+    mlx90632_status_brown_out_t; ///< STATUS brown-out reset occurred
+typedef Adafruit_MLX90632_Field<MLX90632_REG_STATUS, 9, 1>
+    mlx90632_status_eeprom_busy_t; ///< STATUS EEPROM busy
+typedef Adafruit_MLX90632_Field<MLX90632_REG_STATUS, 10, 1>
+    mlx90632_status_device_busy_t; ///< STATUS measurement in progress
+/*=========================================================================*/
+
+/*!
+ *    @brief  States of the EEPROM write engine, see commitEEPROM()
+ */
+typedef enum {
+  MLX90632_EEPROM_IDLE,    ///< No session open
+  MLX90632_EEPROM_QUEUED,  ///< Session open, collecting writes
+  MLX90632_EEPROM_HALTING, ///< Waiting for the running measurement to end
+  MLX90632_EEPROM_ERASING, ///< Erase cycle in progress
+  MLX90632_EEPROM_WRITING, ///< Write cycle in progress
+  MLX90632_EEPROM_DONE,    ///< All writes completed, mode restored
+  MLX90632_EEPROM_FAILED   ///< A transfer failed or timed out, mode restored
+} mlx90632_eeprom_state_t;
+
+#ifndef MLX90632_EEPROM_QUEUE
+#define MLX90632_EEPROM_QUEUE 4 ///< EEPROM words per write session
+#endif
+#ifndef MLX90632_EEPROM_CYCLE_MS
+#define MLX90632_EEPROM_CYCLE_MS \
+  10 ///< Time before the first busy check after an erase or write
+#endif
+#ifndef MLX90632_EEPROM_TIMEOUT_MS
+#define MLX90632_EEPROM_TIMEOUT_MS \
+  (4 * MLX90632_EEPROM_CYCLE_MS) ///< Longest erase or write cycle
+#endif
+
+/*!
+ *    @brief  One queued EEPROM word of a write session
+ */
+typedef struct {
+  uint16_t addr;  ///< EEPROM address
+  uint16_t mask;  ///< Bits to change
+  uint16_t value; ///< New value of the masked bits, then of the whole word
+  uint16_t old;   ///< Word in the EEPROM, 0 once erased
+} mlx90632_eeprom_write_t;
+
+/*!
+ *    @brief  States of the non-blocking measurement state machine
+ */
+typedef enum {
+  MLX90632_STATE_IDLE,      ///< No measurement in progress
+  MLX90632_STATE_TRIGGERED, ///< Measurement started, waiting one period
+  MLX90632_STATE_WAITING,   ///< Checking the status for new data
+  MLX90632_STATE_READING,   ///< New data available, frame read pending
+  MLX90632_STATE_READY      ///< Frame and temperatures available
+} mlx90632_poll_state_t;
+/*=========================================================================*/
+
+#define MLX90632_FRAME_AMBIENT 2 ///< Frame index of RAM_6 / RAM_54
+#define MLX90632_FRAME_REF 5     ///< Frame index of RAM_9 / RAM_57
+
+#ifndef MLX90632_BATCH_BLOCK
+#if defined(__AVR__)
+#define MLX90632_BATCH_BLOCK 8 ///< Frames per computeBatch() block
+#else
+#define MLX90632_BATCH_BLOCK 64 ///< Frames per computeBatch() block
+#endif
+#endif
+
+/*
+ * Define MLX90632_SINGLE_PRECISION (e.g. with a build flag) to run the
+ * temperature calculations in float instead of double. This uses the FPU on
+ * Cortex-M4F and similar parts, and is the native precision on AVR anyway.
+ */
+// #define MLX90632_SINGLE_PRECISION
+
+#ifdef MLX90632_SINGLE_PRECISION
+typedef float mlx90632_real_t; ///< Precision of the temperature calculations
+#else
+typedef double mlx90632_real_t; ///< Precision of the temperature calculations
+#endif
+
+/*
+ * Define MLX90632_STATS (e.g. with a build flag) to count bus failures, NaN
+ * results and frame read latency, see getStats(). Without it the counters,
+ * their accessors and all bookkeeping are compiled out.
+ */
+// #define MLX90632_STATS
+
+#define MLX90632_STATS_BUCKETS 8 ///< Latency histogram buckets
+#define MLX90632_STATS_BUCKET_US \
+  250 ///< Upper edge of the first latency bucket, doubling per bucket
+
+#define MLX90632_EMISSIVITY 1.0 ///< Object emissivity used in calculations
+#define MLX90632_AMB_SCALE \
+  ((mlx90632_real_t)(524288.0 / 12.0)) ///< 2^19 / 12, used by AMB and STO
+
+/*!
+ *    @brief  Calibration terms derived once in getCalibrations(), so the
+ *            per-sample calculation is multiply-adds plus one root
+ */
+typedef struct {
+  mlx90632_real_t P_R;            ///< P_R
+  mlx90632_real_t inv_P_G;        ///< 1 / P_G
+  mlx90632_real_t P_T;            ///< P_T
+  mlx90632_real_t P_O;            ///< P_O
+  mlx90632_real_t Gb_12;          ///< Gb / 12
+  mlx90632_real_t Ka_12;          ///< Ka / 12
+  mlx90632_real_t Eb;             ///< Eb
+  mlx90632_real_t inv_Ea;         ///< 1 / Ea
+  mlx90632_real_t Ga;             ///< Ga
+  mlx90632_real_t Fb;             ///< Fb
+  mlx90632_real_t inv_emiss_FaHa; ///< 1 / (emissivity * Fa * Ha)
+  mlx90632_real_t Hb_K;           ///< Hb + 273.15
+} mlx90632_calibration_t;
+
+/*!
+ *    @brief  Raw RAM snapshot of one measurement, read in a single burst
+ */
+typedef struct {
+  uint8_t meas_select;    ///< Measurement type, an mlx90632_meas_select_t
+  uint8_t cycle_position; ///< Cycle position (medical mode only)
+  int16_t ram[8]; ///< RAM_4..RAM_9 (medical) or RAM_52..RAM_59 (extended)
+} mlx90632_frame_t;
+
+/*!
+ *    @brief  Object temperature solver settings, TO0/TA0 history and the
+ *            medical half-cycle history
+ */
+typedef struct {
+  mlx90632_real_t TO0;       ///< Previous object temperature (starts at 25.0)
+  mlx90632_real_t TA0;       ///< Previous ambient temperature (starts at 25.0)
+  uint8_t max_iterations;    ///< Maximum TODUT iterations per sample
+  mlx90632_real_t tolerance; ///< Convergence tolerance in degrees C
+  uint8_t iterations;        ///< Iterations used by the last sample
+  uint8_t half;              ///< Medical half of the last sample, 0 if none
+  uint8_t halves;            ///< Medical halves seen, bit (half - 1) each
+  bool average_halves;       ///< Medical: average both halves per frame
+  uint16_t period_ms;        ///< Refresh period, 0 disables half inference
+  uint32_t half_ms;          ///< Timestamp of the last medical sample
+} mlx90632_solver_t;
+
+/*!
+ *    @brief  Decoded STATUS register, see readStatus()
+ */
+typedef struct {
+  uint16_t raw;           ///< STATUS register value
+  bool new_data;          ///< A measurement completed since the flag cleared
+  uint8_t cycle_position; ///< Cycle position of the last measurement
+  bool brown_out;         ///< A brown-out reset occurred
+  bool eeprom_busy;       ///< EEPROM write or erase in progress
+  bool device_busy;       ///< Measurement in progress
+} mlx90632_status_t;
+
+/*!
+ *    @brief  Timestamped sample record, see getLastSample()
+ */
+typedef struct {
+  uint32_t timestamp_ms;   ///< millis() when the frame read completed
+  uint16_t status;         ///< STATUS register when new data was seen
+  mlx90632_frame_t frame;  ///< Raw RAM words, measurement type and cycle
+  mlx90632_real_t ambient; ///< Ambient temperature in degrees Celsius
+  mlx90632_real_t object;  ///< Object temperature in degrees Celsius or NaN
+} mlx90632_sample_t;
+
+/*!
+ *    @brief  Outcome of readFrameAsync()
+ */
+typedef enum {
+  MLX90632_ASYNC_DONE,    ///< Frame read, temperatures computed
+  MLX90632_ASYNC_NO_DATA, ///< No new data yet, only the status was read
+  MLX90632_ASYNC_FAILED   ///< A transaction failed
+} mlx90632_async_result_t;
+
+/*!
+ *    @brief  Called when a readFrameAsync() chain ends
+ *    @param  context The context given to readFrameAsync()
+ *    @param  result How the chain ended
+ *    @param  sample The new sample, only valid for MLX90632_ASYNC_DONE
+ */
+typedef void (*mlx90632_async_callback_t)(void* context,
+                                          mlx90632_async_result_t result,
+                                          const mlx90632_sample_t* sample);
+
+#define MLX90632_ASYNC_XFERS 3 ///< Status read, RAM burst, new_data clear
+
+#define MLX90632_CAL_BLOB_MAGIC 0x3290 ///< Marks an mlx90632_cal_blob_t
+
+/*!
+ *    @brief  Calibration of one chip, see exportCalibration(). Store it
+ *            as-is (sizeof(mlx90632_cal_blob_t) bytes) in flash, EEPROM or
+ *            retained RAM and pass it to begin() on the next start.
+ */
+typedef struct {
+  uint16_t magic;      ///< MLX90632_CAL_BLOB_MAGIC
+  uint16_t id[3];      ///< ID0..ID2, the product ID of the chip
+  uint16_t ee_version; ///< EEPROM version
+  uint16_t ee[MLX90632_CAL_BLOCK_WORDS]; ///< Raw EE_P_R_LSW..EE_KB words
+  uint16_t ee_h[2];                      ///< Raw EE_HA and EE_HB words
+  uint16_t crc; ///< CRC-16/CCITT-FALSE of all words above
+} mlx90632_cal_blob_t;
+
+/*!
+ *    @brief  Driver counters collected when MLX90632_STATS is defined.
+ *            Latency is the time from poll() seeing new data (or
+ *            notifyDataReady()) to the end of the frame read, including
+ *            retries. Histogram bucket i counts latencies below
+ *            MLX90632_STATS_BUCKET_US << i microseconds, the last bucket
+ *            everything longer.
+ */
+typedef struct {
+  uint32_t transactions;       ///< Register transactions issued
+  uint32_t failed_reads;       ///< Register reads that failed (e.g. NACK)
+  uint32_t failed_writes;      ///< Register writes that failed (e.g. NACK)
+  uint32_t frames;             ///< Frames read successfully
+  uint32_t cycle_position[4];  ///< Medical frames at position 0, 1, 2, other
+  uint32_t nan_read_failed;    ///< NaN results from a failed frame read
+  uint32_t nan_cycle_position; ///< NaN object results, half-cycle unknown
+  uint32_t nan_math;           ///< NaN results from the calculation itself
+  uint32_t latency_count;      ///< Latencies recorded by poll()
+  uint32_t latency_last_us;    ///< Last latency in microseconds
+  uint32_t latency_min_us;     ///< Shortest latency, UINT32_MAX if none yet
+  uint32_t latency_max_us;     ///< Longest latency
+  uint32_t latency_total_us;   ///< Sum of all latencies, for the mean
+
+  uint32_t latency_histogram[MLX90632_STATS_BUCKETS]; ///< Latency histogram
+} mlx90632_stats_t;
+
 /*!
  *    @brief  Class that stores state and functions for interacting with
  *            MLX90632 Far Infrared Temperature Sensor
@@ -202,8 +503,16 @@ typedef enum {
 class Adafruit_MLX90632 {
  public:
   Adafruit_MLX90632();
-  ~Adafruit_MLX90632();
-  bool begin(uint8_t i2c_addr = MLX90632_DEFAULT_ADDR, TwoWire* wire = &Wire);
+  bool begin(uint8_t i2c_addr = MLX90632_DEFAULT_ADDR,
+             mlx90632_bus_t* bus = MLX90632_DEFAULT_BUS);
+  bool begin(const mlx90632_cal_blob_t& blob,
+             uint8_t i2c_addr = MLX90632_DEFAULT_ADDR,
+             mlx90632_bus_t* bus = MLX90632_DEFAULT_BUS);
+  bool exportCalibration(mlx90632_cal_blob_t* blob);
+  static bool checkCalibration(const mlx90632_cal_blob_t& blob);
+  static bool calibrationFromBlob(const mlx90632_cal_blob_t& blob,
+                                  mlx90632_calibration_t* cal);
+  bool isWarmStarted();
   uint64_t getProductID();
   uint16_t getProductCode();
   uint16_t getEEPROMVersion();
@@ -213,52 +522,191 @@ class Adafruit_MLX90632 {
   mlx90632_mode_t getMode();
   bool setMeasurementSelect(mlx90632_meas_select_t meas_select);
   mlx90632_meas_select_t getMeasurementSelect();
+  bool resync();
+  bool readStatus(mlx90632_status_t* status);
+  static void decodeStatus(uint16_t raw, mlx90632_status_t* status);
   bool isBusy();
   bool isEEPROMBusy();
-  bool reset();
+  bool reset(bool wait = true);
   uint8_t readCyclePosition();
-  bool resetNewData();
+  bool resetNewData(const mlx90632_status_t* status = nullptr);
   bool isNewData();
   bool setRefreshRate(mlx90632_refresh_rate_t refresh_rate);
+  bool beginEEPROMWrite();
+  bool writeEEPROM(uint16_t addr, uint16_t value, uint16_t mask = 0xFFFF);
+  bool commitEEPROM(bool wait = true);
+  mlx90632_eeprom_state_t pollEEPROM();
+  uint8_t getEEPROMCycles();
   mlx90632_refresh_rate_t getRefreshRate();
+  uint16_t getRefreshPeriod();
   bool getCalibrations();
   double getAmbientTemperature();
   double getObjectTemperature();
+  bool readFrame(mlx90632_frame_t* frame,
+                 const mlx90632_status_t* status = nullptr);
+  bool readTemperatures(double* ambient, double* object,
+                        const mlx90632_status_t* status = nullptr);
+  double getAmbientTemperature(const mlx90632_frame_t& frame);
+  double getObjectTemperature(const mlx90632_frame_t& frame);
+  bool setSolver(uint8_t max_iterations, double tolerance = 0.01);
+  uint8_t getSolverIterations();
+  void setHalfCycleAveraging(bool enable);
+  uint8_t getLastHalfCycle();
+  const mlx90632_solver_t& getSolverState();
+  const mlx90632_calibration_t& getCalibration();
+  static void initSolver(mlx90632_solver_t* solver);
+  static mlx90632_real_t computeAmbient(const mlx90632_frame_t& frame,
+                                        const mlx90632_calibration_t& cal);
+  static mlx90632_real_t computeObject(
+      const mlx90632_frame_t& frame, const mlx90632_calibration_t& cal,
+      mlx90632_solver_t* solver, const uint32_t* timestamp_ms = nullptr);
+  static void computeBatch(const mlx90632_frame_t* frames, size_t count,
+                           const mlx90632_calibration_t& cal,
+                           mlx90632_solver_t* solver, mlx90632_real_t* ambient,
+                           mlx90632_real_t* object,
+                           const uint32_t* timestamps_ms = nullptr);
+  mlx90632_poll_state_t poll();
+  mlx90632_poll_state_t getPollState();
+  uint32_t getNextPollTime();
+  const mlx90632_frame_t& getLastFrame();
+  double getLastAmbientTemperature();
+  double getLastObjectTemperature();
+  void getLastSample(mlx90632_sample_t* sample);
+  void setDataReadyNotify(bool enable);
+  void notifyDataReady();
+  bool readFrameAsync(mlx90632_async_callback_t callback,
+                      void* context = nullptr);
+  bool isAsyncBusy();
+  void setTrace(Adafruit_MLX90632_TraceRecorder* recorder);
+  uint32_t getTransactionCount();
+  void resetTransactionCount();
+  uint32_t getStatusReadCount();
+  uint16_t getCalibrationTransactionsSaved();
+#ifdef MLX90632_STATS
+  const mlx90632_stats_t& getStats();
+  void resetStats();
+#endif
 
  private:
-  Adafruit_I2CDevice* i2c_dev; ///< Pointer to I2C bus interface
-  uint16_t swapBytes(
-      uint16_t value); ///< Byte swap helper for register addresses
-  uint32_t read32BitRegister(
-      uint16_t lsw_addr); ///< Helper to read 32-bit values
-
-  // Calibration constants
-  double P_R; ///< P_R calibration constant
-  double P_G; ///< P_G calibration constant
-  double P_T; ///< P_T calibration constant
-  double P_O; ///< P_O calibration constant
-  double Aa;  ///< Aa calibration constant
-  double Ab;  ///< Ab calibration constant
-  double Ba;  ///< Ba calibration constant
-  double Bb;  ///< Bb calibration constant
-  double Ca;  ///< Ca calibration constant
-  double Cb;  ///< Cb calibration constant
-  double Da;  ///< Da calibration constant
-  double Db;  ///< Db calibration constant
-  double Ea;  ///< Ea calibration constant
-  double Eb;  ///< Eb calibration constant
-  double Fa;  ///< Fa calibration constant
-  double Fb;  ///< Fb calibration constant
-  double Ga;  ///< Ga calibration constant
-  double Gb;  ///< Gb calibration constant
-  double Ka;  ///< Ka calibration constant
-  int16_t Kb; ///< Kb calibration constant (16-bit signed)
-  double Ha;  ///< Ha calibration constant
-  double Hb;  ///< Hb calibration constant
-
-  // Temperature calculation variables
-  double TO0; ///< Previous object temperature (starts at 25.0)
-  double TA0; ///< Previous ambient temperature (starts at 25.0)
+  mlx90632_transport_t transport;         ///< I2C bus interface
+  Adafruit_MLX90632_TraceRecorder* trace; ///< Gets every transaction, or null
+  bool readRegisters(uint16_t start_addr, uint16_t* words,
+                     uint16_t count); ///< Burst read of consecutive registers
+  bool writeRegister(uint16_t addr,
+                     uint16_t value);    ///< Write a single 16-bit register
+  bool readStatusWord(uint16_t* status); ///< Counted STATUS register read
+
+  /*!
+   *    @brief  Read one register field
+   *    @tparam FIELD An Adafruit_MLX90632_Field
+   *    @param  value Pointer to store the field value
+   *    @return True if the read succeeded, false otherwise
+   */
+  template <typename FIELD>
+  bool readField(uint16_t* value) {
+    uint16_t reg;
+
+    if (FIELD::address() == MLX90632_REG_STATUS) {
+      status_reads++;
+    }
+    if (!readRegisters(FIELD::address(), &reg, 1)) {
+      return false;
+    }
+    *value = FIELD::get(reg);
+    return true;
+  }
+
+  /*!
+   *    @brief  Write one register field, merging it into a shadow of the
+   *            rest of the register. The shadow is only updated on success.
+   *    @tparam FIELD An Adafruit_MLX90632_Field
+   *    @param  shadow Driver-side copy of the register
+   *    @param  value New field value
+   *    @return True if the write succeeded, false otherwise
+   */
+  template <typename FIELD>
+  bool writeField(uint16_t* shadow, uint16_t value) {
+    uint16_t reg = FIELD::set(*shadow, value);
+
+    if (!writeRegister(FIELD::address(), reg)) {
+      return false;
+    }
+    *shadow = reg;
+    return true;
+  }
+  bool beginDevice(uint8_t i2c_addr,
+                   mlx90632_bus_t* bus); ///< Bind and probe the I2C device
+  void applyCalibration(
+      const uint16_t* ee,
+      const uint16_t* ee_h); ///< Derive terms from raw EEPROM words
+  bool eraseOrWriteEEPROM(uint16_t addr,
+                          uint16_t value); ///< Unlock and start one cycle
+  bool startEEPROMWord(); ///< Start the next cycle or end the session
+  mlx90632_eeprom_state_t finishEEPROM(
+      bool ok); ///< Restore the mode and end the session
+  bool readFrameRAM(
+      mlx90632_frame_t* frame); ///< Burst read the RAM window of a frame
+  static bool asyncStatusDone(
+      mlx90632_xfer_t* xfer); ///< Check new_data, prepare the clear
+  static bool asyncRAMDone(mlx90632_xfer_t* xfer);   ///< Unpack the RAM words
+  static bool asyncClearDone(mlx90632_xfer_t* xfer); ///< Finish the sample
+  bool asyncTransaction(
+      mlx90632_xfer_t* xfer); ///< Count a chain transaction, false if failed
+  void finishAsync(
+      mlx90632_async_result_t result); ///< Compute and call the callback
+
+  uint32_t transactions;           ///< Register transactions issued
+  uint32_t status_reads;           ///< STATUS reads among the transactions
+  uint16_t cal_transactions_saved; ///< Transactions saved by getCalibrations()
+  bool warm_started;               ///< Calibration came from a blob
+
+  // Driver-side register shadows, kept up to date by the setters
+  uint16_t control_shadow; ///< Shadow of MLX90632_REG_CONTROL
+  uint16_t meas1_shadow;   ///< Shadow of MLX90632_REG_EE_MEAS_1
+  uint16_t meas2_shadow;   ///< Shadow of MLX90632_REG_EE_MEAS_2
+
+  mlx90632_calibration_t cal; ///< Derived terms used by the calculations
+
+  mlx90632_solver_t solver; ///< Solver settings and TO0/TA0 history
+
+  // Non-blocking state machine
+  mlx90632_poll_state_t poll_state; ///< Current state
+  uint32_t poll_next_ms;            ///< millis() when poll() next has work
+  uint16_t poll_status;             ///< STATUS read when new data was seen
+  mlx90632_frame_t poll_frame;      ///< Frame of the last completed sample
+  double poll_ambient;              ///< Ambient of the last completed sample
+  double poll_object;               ///< Object of the last completed sample
+  uint32_t poll_ready_ms;           ///< millis() of the last completed sample
+  bool resync_pending;              ///< Reload shadows after reset(false)
+  bool data_ready_notify;           ///< Wait for notifyDataReady() in poll()
+  volatile bool data_ready_flag;    ///< Set by notifyDataReady()
+
+  // EEPROM write engine
+  mlx90632_eeprom_write_t ee_queue[MLX90632_EEPROM_QUEUE]; ///< Session words
+  mlx90632_eeprom_state_t ee_state;                        ///< Current state
+  uint8_t ee_count;              ///< Words in ee_queue
+  uint8_t ee_index;              ///< Word being erased or written
+  uint8_t ee_cycles;             ///< Erase and write cycles this session
+  uint32_t ee_next_ms;           ///< millis() of the next busy check
+  uint32_t ee_deadline_ms;       ///< millis() the current wait fails at
+  mlx90632_mode_t ee_saved_mode; ///< Mode to restore after the session
+
+  // Asynchronous frame read
+  mlx90632_xfer_t async_xfer[MLX90632_ASYNC_XFERS]; ///< Descriptor chain
+  uint8_t async_rx[2 * 8];                          ///< Status, then RAM words
+  mlx90632_sample_t async_sample;                   ///< Sample being read
+  mlx90632_async_callback_t async_callback; ///< Called when the chain ends
+  void* async_context;                      ///< For async_callback
+  volatile bool async_busy;                 ///< A chain is in flight
+
+#ifdef MLX90632_STATS
+  mlx90632_stats_t stats;            ///< Counters, see getStats()
+  uint32_t stats_ready_us;           ///< micros() when data was seen ready
+  volatile uint32_t stats_notify_us; ///< micros() of notifyDataReady()
+  void recordLatency(uint32_t latency_us); ///< Add a latency to the stats
+  void recordFrame(
+      const mlx90632_frame_t& frame); ///< Count a frame and its position
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,439 @@
+/*!
+ *  @file Adafruit_MLX90632_Log.cpp
+ *
+ * 	Compact binary log of raw MLX90632 frames, see Adafruit_MLX90632_Log.h
+ *  for the format.
+ *
+ * 	MIT license, see LICENSE for more information
+ */
+
+#include "Adafruit_MLX90632_Log.h"
+
+static const uint8_t log_magic[4] = {'M', 'L', 'X', 'F'}; ///< Header start
+
+/*!
+ *    @brief  CRC-16/CCITT-FALSE of a byte range, four bits at a time from a
+ *            16-entry table so it stays small on an MCU
+ *    @param  data Bytes to check
+ *    @param  len Number of bytes
+ *    @return CRC
+ */
+static uint16_t logCRC(const uint8_t* data, size_t len) {
+  static const uint16_t table[16] = {
+      0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+      0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+  uint16_t crc = 0xFFFF;
+
+  for (size_t i = 0; i < len; i++) {
+    crc = (uint16_t)(crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+    crc = (uint16_t)(crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)];
+  }
+  return crc;
+}
+
+/*!
+ *    @brief  Append an unsigned LEB128 varint
+ *    @param  p Where to write, advanced past the varint
+ *    @param  value Value to write
+ */
+static inline void putVarint(uint8_t*& p, uint32_t value) {
+  while (value >= 0x80) {
+    *p++ = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  *p++ = (uint8_t)value;
+}
+
+/*!
+ *    @brief  Read an unsigned LEB128 varint
+ *    @param  p Where to read, advanced past the varint
+ *    @param  end End of the readable bytes
+ *    @param  value Value read
+ *    @return False if the varint runs past end or 32 bits
+ */
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end,
+                             uint32_t* value) {
+  uint32_t v = 0;
+
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (p >= end) {
+      return false;
+    }
+    uint8_t b = *p++;
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      *value = v;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ *    @brief  Get the RAM words a measurement type fills
+ *    @param  meas_select Measurement type
+ *    @return 6 or 8, or 0 for an unknown type
+ */
+static uint8_t frameWords(uint8_t meas_select) {
+  switch (meas_select) {
+    case MLX90632_MEAS_MEDICAL:
+      return 6;
+    case MLX90632_MEAS_EXTENDED_RANGE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+/*!
+ *    @brief  Instantiates an encoder that rejects frames until begin()
+ */
+Adafruit_MLX90632_LogEncoder::Adafruit_MLX90632_LogEncoder() {
+  length = 0;
+  writer = nullptr;
+  write_context = nullptr;
+  meas_select = MLX90632_MEAS_MEDICAL;
+  words = 0;
+  memset(last_ram, 0, sizeof(last_ram));
+  last_ms = 0;
+  frames = 0;
+  blocks = 0;
+}
+
+/*!
+ *    @brief  Start a new log and write its header
+ *    @param  blob Calibration of the sensor, from exportCalibration()
+ *    @param  meas_select Measurement type of every frame that will be added
+ *    @param  write Stores the header and each full block
+ *    @param  context Passed to write
+ *    @return False if the blob or measurement type is invalid, or the
+ *            header couldn't be written
+ */
+bool Adafruit_MLX90632_LogEncoder::begin(const mlx90632_cal_blob_t& blob,
+                                         mlx90632_meas_select_t meas_select,
+                                         mlx90632_log_write_t write,
+                                         void* context) {
+  uint8_t header[MLX90632_LOG_HEADER];
+  const uint16_t* blob_words = (const uint16_t*)&blob;
+  uint8_t* p = header;
+
+  writer = nullptr;
+  words = frameWords(meas_select);
+  if (!write || !words || !Adafruit_MLX90632::checkCalibration(blob)) {
+    return false;
+  }
+
+  memcpy(p, log_magic, sizeof(log_magic));
+  p += sizeof(log_magic);
+  *p++ = MLX90632_LOG_VERSION;
+  *p++ = (uint8_t)meas_select;
+  *p++ = (uint8_t)(MLX90632_LOG_BLOCK >> 8);
+  *p++ = (uint8_t)(MLX90632_LOG_BLOCK & 0xFF);
+  for (size_t i = 0; i < sizeof(blob) / sizeof(uint16_t); i++) {
+    *p++ = (uint8_t)(blob_words[i] >> 8);
+    *p++ = (uint8_t)(blob_words[i] & 0xFF);
+  }
+  uint16_t crc = logCRC(header, p - header);
+  *p++ = (uint8_t)(crc >> 8);
+  *p++ = (uint8_t)(crc & 0xFF);
+  if (!write(context, header, sizeof(header))) {
+    return false;
+  }
+
+  writer = write;
+  write_context = context;
+  this->meas_select = meas_select;
+  block[0] = 0;
+  length = 1;
+  frames = 0;
+  blocks = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Encode one frame
+ *    @param  frame Frame to encode
+ *    @param  timestamp_ms Time of the frame
+ *    @param  first True to encode it as the first frame of a block
+ *    @param  out At least MLX90632_LOG_MAX_FRAME bytes
+ *    @return Bytes written to out
+ */
+size_t Adafruit_MLX90632_LogEncoder::encode(const mlx90632_frame_t& frame,
+                                            uint32_t timestamp_ms, bool first,
+                                            uint8_t* out) {
+  uint8_t* p = out;
+
+  putVarint(p, first ? timestamp_ms : timestamp_ms - last_ms);
+  *p++ = frame.cycle_position;
+  for (uint8_t i = 0; i < words; i++) {
+    // Differences wrap in 16 bits, so every word fits in three bytes
+    int16_t delta =
+        (int16_t)(uint16_t)(frame.ram[i] - (first ? 0 : last_ram[i]));
+    putVarint(p, (uint16_t)((uint16_t)delta << 1) ^ (uint16_t)(delta >> 15));
+  }
+  return p - out;
+}
+
+/*!
+ *    @brief  Append a frame, writing the block first if the frame doesn't
+ *            fit. Frames must come in time order.
+ *    @param  frame Frame from readFrame(), getLastFrame() or an async read
+ *    @param  timestamp_ms Time of the frame, e.g. millis()
+ *    @return False if the encoder isn't begun, the frame has another
+ *            measurement type than the log, or a full block couldn't be
+ *            written. The frame isn't added then.
+ */
+bool Adafruit_MLX90632_LogEncoder::add(const mlx90632_frame_t& frame,
+                                       uint32_t timestamp_ms) {
+  uint8_t encoded[MLX90632_LOG_MAX_FRAME];
+
+  if (!writer || frame.meas_select != meas_select) {
+    return false;
+  }
+  size_t n = encode(frame, timestamp_ms, block[0] == 0, encoded);
+  if (block[0] == 0xFF || length + n > sizeof(block) - 2) {
+    if (!flush()) {
+      return false;
+    }
+    n = encode(frame, timestamp_ms, true, encoded);
+  }
+
+  memcpy(block + length, encoded, n);
+  length += n;
+  block[0]++;
+  memcpy(last_ram, frame.ram, sizeof(last_ram));
+  last_ms = timestamp_ms;
+  frames++;
+  return true;
+}
+
+/*!
+ *    @brief  Pad and write the current block, e.g. before closing the file.
+ *            The next frame starts a new block.
+ *    @return True if the block was written or was empty
+ */
+bool Adafruit_MLX90632_LogEncoder::flush() {
+  if (!writer) {
+    return false;
+  }
+  if (block[0] == 0) {
+    return true;
+  }
+
+  memset(block + length, 0, sizeof(block) - 2 - length);
+  uint16_t crc = logCRC(block, sizeof(block) - 2);
+  block[sizeof(block) - 2] = (uint8_t)(crc >> 8);
+  block[sizeof(block) - 1] = (uint8_t)(crc & 0xFF);
+  if (!writer(write_context, block, sizeof(block))) {
+    return false;
+  }
+  block[0] = 0;
+  length = 1;
+  blocks++;
+  return true;
+}
+
+/*!
+ *    @brief  Get the number of frames added since begin()
+ *    @return Frame count, including those not yet written
+ */
+uint32_t Adafruit_MLX90632_LogEncoder::getFrameCount() {
+  return frames;
+}
+
+/*!
+ *    @brief  Get the number of blocks written since begin()
+ *    @return Block count
+ */
+uint32_t Adafruit_MLX90632_LogEncoder::getBlockCount() {
+  return blocks;
+}
+
+/*!
+ *    @brief  Instantiates a decoder without a log
+ */
+Adafruit_MLX90632_LogDecoder::Adafruit_MLX90632_LogDecoder() {
+  log = nullptr;
+  length = 0;
+  block_size = 0;
+  block_start = 0;
+  position = 0;
+  remaining = 0;
+  memset(&blob, 0, sizeof(blob));
+  memset(&last, 0, sizeof(last));
+  last_ms = 0;
+  frames = 0;
+  bad_blocks = 0;
+}
+
+/*!
+ *    @brief  Check the header of a log and start reading its first block
+ *    @param  log Complete log, header included
+ *    @param  len Bytes in the log
+ *    @return False if the header is missing, corrupted or of another
+ *            version
+ */
+bool Adafruit_MLX90632_LogDecoder::begin(const uint8_t* log, size_t len) {
+  uint16_t* blob_words = (uint16_t*)&blob;
+  const uint8_t* p = log + sizeof(log_magic) + 1;
+
+  this->log = nullptr;
+  if (!log || len < MLX90632_LOG_HEADER ||
+      memcmp(log, log_magic, sizeof(log_magic)) != 0 ||
+      log[sizeof(log_magic)] != MLX90632_LOG_VERSION ||
+      logCRC(log, MLX90632_LOG_HEADER - 2) !=
+          (((uint16_t)log[MLX90632_LOG_HEADER - 2] << 8) |
+           log[MLX90632_LOG_HEADER - 1])) {
+    return false;
+  }
+
+  uint8_t meas_select = *p++;
+  size_t size = ((size_t)p[0] << 8) | p[1];
+  p += 2;
+  for (size_t i = 0; i < sizeof(blob) / sizeof(uint16_t); i++, p += 2) {
+    blob_words[i] = ((uint16_t)p[0] << 8) | p[1];
+  }
+  if (!frameWords(meas_select) || size < MLX90632_LOG_MIN_BLOCK ||
+      size > MLX90632_LOG_MAX_BLOCK ||
+      !Adafruit_MLX90632::checkCalibration(blob)) {
+    return false;
+  }
+
+  this->log = log;
+  length = len;
+  block_size = size;
+  block_start = MLX90632_LOG_HEADER;
+  position = block_start;
+  remaining = 0;
+  memset(&last, 0, sizeof(last));
+  last.meas_select = meas_select;
+  last_ms = 0;
+  frames = 0;
+  bad_blocks = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Get the calibration stored in the header, e.g. for
+ *            Adafruit_MLX90632::calibrationFromBlob()
+ *    @return Calibration blob, its product ID identifies the sensor
+ */
+const mlx90632_cal_blob_t& Adafruit_MLX90632_LogDecoder::getCalibrationBlob() {
+  return blob;
+}
+
+/*!
+ *    @brief  Get the measurement type of the logged frames
+ *    @return Measurement type from the header
+ */
+mlx90632_meas_select_t Adafruit_MLX90632_LogDecoder::getMeasurementSelect() {
+  return (mlx90632_meas_select_t)last.meas_select;
+}
+
+/*!
+ *    @brief  Move to the next block with a valid CRC, skipping and
+ *            counting bad ones
+ *    @return False if no complete block is left
+ */
+bool Adafruit_MLX90632_LogDecoder::openBlock() {
+  while (log && block_start + block_size <= length) {
+    const uint8_t* b = log + block_start;
+    uint16_t crc = ((uint16_t)b[block_size - 2] << 8) | b[block_size - 1];
+
+    block_start += block_size;
+    if (b[0] && logCRC(b, block_size - 2) == crc) {
+      position = block_start - block_size + 1;
+      remaining = b[0];
+      return true;
+    }
+    bad_blocks++;
+  }
+  return false;
+}
+
+/*!
+ *    @brief  Decode the next frame
+ *    @param  frame Frame to fill; RAM words the measurement type doesn't
+ *            use are zero
+ *    @param  timestamp_ms Time of the frame, or nullptr
+ *    @return False at the end of the log. A partly written last block is
+ *            ignored.
+ */
+bool Adafruit_MLX90632_LogDecoder::next(mlx90632_frame_t* frame,
+                                        uint32_t* timestamp_ms) {
+  uint8_t words = frameWords(last.meas_select);
+
+  while (remaining || openBlock()) {
+    const uint8_t* p = log + position;
+    const uint8_t* end = log + block_start - 2;
+    bool first = position == block_start - block_size + 1;
+    mlx90632_frame_t f = last;
+    uint32_t value;
+
+    if (!getVarint(p, end, &value) || p >= end) {
+      remaining = 0;
+      bad_blocks++;
+      continue;
+    }
+    uint32_t ms = first ? value : last_ms + value;
+    f.cycle_position = *p++;
+    uint8_t i = 0;
+    for (; i < words && getVarint(p, end, &value) && value <= 0xFFFF; i++) {
+      int16_t delta = (int16_t)((value >> 1) ^ (0U - (value & 1)));
+      f.ram[i] = (int16_t)(uint16_t)((first ? 0 : f.ram[i]) + delta);
+    }
+    if (i < words) {
+      remaining = 0;
+      bad_blocks++;
+      continue;
+    }
+
+    position = p - log;
+    remaining--;
+    last = f;
+    last_ms = ms;
+    frames++;
+    *frame = f;
+    if (timestamp_ms) {
+      *timestamp_ms = ms;
+    }
+    return true;
+  }
+  return false;
+}
+
+/*!
+ *    @brief  Decode up to max frames at once
+ *    @param  buffer Frames to fill
+ *    @param  timestamps_ms Times of the frames, or nullptr
+ *    @param  max Capacity of buffer and timestamps_ms
+ *    @return Frames decoded, less than max at the end of the log
+ */
+size_t Adafruit_MLX90632_LogDecoder::read(mlx90632_frame_t* buffer,
+                                          uint32_t* timestamps_ms,
+                                          size_t max) {
+  size_t n = 0;
+
+  while (n < max &&
+         next(&buffer[n], timestamps_ms ? &timestamps_ms[n] : nullptr)) {
+    n++;
+  }
+  return n;
+}
+
+/*!
+ *    @brief  Get the number of frames decoded since begin()
+ *    @return Frame count
+ */
+uint32_t Adafruit_MLX90632_LogDecoder::getFrameCount() {
+  return frames;
+}
+
+/*!
+ *    @brief  Get the number of blocks skipped because their CRC or
+ *            contents were bad
+ *    @return Bad block count
+ */
+uint32_t Adafruit_MLX90632_LogDecoder::getBadBlockCount() {
+  return bad_blocks;
+}
@@ -0,0 +1,130 @@
+/*!
+ *  @file Adafruit_MLX90632_Log.h
+ *
+ * 	Compact binary log of raw MLX90632 frames
+ *
+ *  A log stores the RAM words of each frame rather than temperatures, so it
+ *  can be converted again offline with a newer driver or a different
+ *  emissivity. It is an append-only byte stream of a header and fixed-size
+ *  blocks.
+ *
+ *  Header, MLX90632_LOG_HEADER bytes:
+ *
+ *  - "MLXF" and the format version
+ *  - the measurement type (mlx90632_meas_select_t) of every frame
+ *  - the block size, big-endian
+ *  - the calibration blob of the sensor (see exportCalibration()) as 45
+ *    big-endian words: product ID, EEPROM version, the raw calibration
+ *    words and the blob's own CRC
+ *  - CRC-16/CCITT-FALSE of the bytes above, big-endian
+ *
+ *  Block, block size bytes:
+ *
+ *  - number of frames in the block
+ *  - per frame: the time in milliseconds as an unsigned LEB128 varint, the
+ *    cycle position byte, then one zigzag varint per RAM word (6 medical,
+ *    8 extended range)
+ *  - zero padding
+ *  - CRC-16/CCITT-FALSE of the bytes above, big-endian
+ *
+ *  The first frame of a block holds its absolute time and RAM words, later
+ *  frames the difference to the frame before. Each block decodes on its
+ *  own, so a corrupted block loses only its frames. A medical frame whose
+ *  words moved by less than 64 LSB takes 8 bytes, about 9 with the block
+ *  overhead, against 16 for the raw words and a 32-bit time.
+ *
+ * 	MIT license, see LICENSE for more information
+ */
+
+#ifndef _ADAFRUIT_MLX90632_LOG_H
+#define _ADAFRUIT_MLX90632_LOG_H
+
+#include "Adafruit_MLX90632.h"
+
+#define MLX90632_LOG_VERSION 1      ///< Format version in the header
+#define MLX90632_LOG_HEADER 100     ///< Header bytes
+#define MLX90632_LOG_MAX_FRAME 30   ///< Largest encoded frame
+#define MLX90632_LOG_MIN_BLOCK 64   ///< Smallest block size
+#define MLX90632_LOG_MAX_BLOCK 4096 ///< Largest block size
+
+#ifndef MLX90632_LOG_BLOCK
+#define MLX90632_LOG_BLOCK 256 ///< Block size written by the encoder
+#endif
+#if MLX90632_LOG_BLOCK < MLX90632_LOG_MIN_BLOCK || \
+    MLX90632_LOG_BLOCK > MLX90632_LOG_MAX_BLOCK
+#error "MLX90632_LOG_BLOCK must be between 64 and 4096"
+#endif
+
+/*!
+ *    @brief  Called by the encoder with the header and each full block,
+ *            e.g. to append them to a file on SD
+ *    @param  context The context given to begin()
+ *    @param  data Bytes to store
+ *    @param  len Number of bytes
+ *    @return True if the bytes were stored
+ */
+typedef bool (*mlx90632_log_write_t)(void* context, const uint8_t* data,
+                                     size_t len);
+
+/*!
+ *    @brief  Packs frames into log blocks. Needs no heap: the block being
+ *            filled lives in the object.
+ */
+class Adafruit_MLX90632_LogEncoder {
+ public:
+  Adafruit_MLX90632_LogEncoder();
+  bool begin(const mlx90632_cal_blob_t& blob,
+             mlx90632_meas_select_t meas_select, mlx90632_log_write_t write,
+             void* context = nullptr);
+  bool add(const mlx90632_frame_t& frame, uint32_t timestamp_ms);
+  bool flush();
+  uint32_t getFrameCount();
+  uint32_t getBlockCount();
+
+ private:
+  size_t encode(const mlx90632_frame_t& frame, uint32_t timestamp_ms,
+                bool first, uint8_t* out);
+
+  uint8_t block[MLX90632_LOG_BLOCK]; ///< Block being filled
+  size_t length;                     ///< Bytes in block
+  mlx90632_log_write_t writer;       ///< Stores the header and blocks
+  void* write_context;               ///< For writer
+  uint8_t meas_select;               ///< Measurement type of every frame
+  uint8_t words;                     ///< RAM words per frame
+  int16_t last_ram[8];               ///< RAM words of the previous frame
+  uint32_t last_ms;                  ///< Time of the previous frame
+  uint32_t frames;                   ///< Frames added since begin()
+  uint32_t blocks;                   ///< Blocks written since begin()
+};
+
+/*!
+ *    @brief  Reads frames back from a complete log in memory
+ */
+class Adafruit_MLX90632_LogDecoder {
+ public:
+  Adafruit_MLX90632_LogDecoder();
+  bool begin(const uint8_t* log, size_t len);
+  const mlx90632_cal_blob_t& getCalibrationBlob();
+  mlx90632_meas_select_t getMeasurementSelect();
+  bool next(mlx90632_frame_t* frame, uint32_t* timestamp_ms = nullptr);
+  size_t read(mlx90632_frame_t* buffer, uint32_t* timestamps_ms, size_t max);
+  uint32_t getFrameCount();
+  uint32_t getBadBlockCount();
+
+ private:
+  bool openBlock();
+
+  const uint8_t* log;       ///< Log being read
+  size_t length;            ///< Bytes in log
+  size_t block_size;        ///< Block size from the header
+  size_t block_start;       ///< Offset of the current block
+  size_t position;          ///< Offset of the next frame
+  uint8_t remaining;        ///< Frames left in the current block
+  mlx90632_cal_blob_t blob; ///< Calibration from the header
+  mlx90632_frame_t last;    ///< Previous frame
+  uint32_t last_ms;         ///< Time of the previous frame
+  uint32_t frames;          ///< Frames decoded
+  uint32_t bad_blocks;      ///< Blocks skipped for a bad CRC or contents
+};
+
+#endif
@@ -0,0 +1,228 @@
+/*!
+ *  @file Adafruit_MLX90632_Manager.cpp
+ *
+ * 	Round-robin scheduler for several MLX90632 sensors on one I2C bus
+ *
+ * 	This is a library for the Adafruit MLX90632 breakout:
+ * 	http://www.adafruit.com/products
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	MIT license, see LICENSE for more information
+ */
+
+#include "Adafruit_MLX90632_Manager.h"
+
+/*!
+ *    @brief  Instantiates a new manager with no sensors
+ */
+Adafruit_MLX90632_Manager::Adafruit_MLX90632_Manager() {
+  count = 0;
+  callback = nullptr;
+  begin_ms = 0;
+  total_samples = 0;
+}
+
+/*!
+ *    @brief  Add a sensor that has already been set up with begin()
+ *    @param  sensor The sensor to manage
+ *    @param  select Optional callback to route the bus to this sensor, called
+ *            before every access
+ *    @param  channel Channel number passed to select
+ *    @return True if the sensor was added, false if the manager is full
+ */
+bool Adafruit_MLX90632_Manager::addSensor(Adafruit_MLX90632* sensor,
+                                          mlx90632_bus_select_t select,
+                                          uint8_t channel) {
+  if (count >= MLX90632_MANAGER_MAX_SENSORS || sensor == nullptr) {
+    return false;
+  }
+
+  slot_t& slot = slots[count++];
+  slot.sensor = sensor;
+  slot.select = select;
+  slot.channel = channel;
+  slot.started = false;
+  slot.halted = false;
+  slot.halted_ms = 0;
+  slot.start_ms = 0;
+  slot.cycle_ms = 0;
+  slot.samples = 0;
+  slot.latency_sum_ms = 0;
+  slot.latency_max_ms = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Get the number of managed sensors
+ *    @return Number of sensors
+ */
+uint8_t Adafruit_MLX90632_Manager::getSensorCount() {
+  return count;
+}
+
+/*!
+ *    @brief  Get a managed sensor
+ *    @param  index Index in the order the sensors were added
+ *    @return The sensor, or nullptr if index is out of range
+ */
+Adafruit_MLX90632* Adafruit_MLX90632_Manager::getSensor(uint8_t index) {
+  return (index < count) ? slots[index].sensor : nullptr;
+}
+
+/*!
+ *    @brief  Set a callback to run for each completed sample
+ *    @param  callback Function to call, or nullptr to disable
+ */
+void Adafruit_MLX90632_Manager::setSampleCallback(
+    mlx90632_sample_callback_t callback) {
+  this->callback = callback;
+}
+
+/*!
+ *    @brief  Start scheduling. Sensor i gets its first trigger i/N of its
+ *            refresh period after begin(), so measurements (and the bus
+ *            traffic that follows them) are spread evenly over the period.
+ */
+void Adafruit_MLX90632_Manager::begin() {
+  begin_ms = millis();
+  total_samples = 0;
+
+  for (uint8_t i = 0; i < count; i++) {
+    slot_t& slot = slots[i];
+    slot.started = false;
+    slot.halted = false;
+    slot.start_ms =
+        begin_ms + (uint32_t)slot.sensor->getRefreshPeriod() * i / count;
+    slot.samples = 0;
+    slot.latency_sum_ms = 0;
+    slot.latency_max_ms = 0;
+  }
+}
+
+/*!
+ *    @brief  Service every sensor that has work due, earliest deadline
+ *            first. A halted sensor is only looked at once per refresh
+ *            period. Call this often from loop().
+ *    @return Number of samples completed during this call
+ */
+uint8_t Adafruit_MLX90632_Manager::update() {
+  uint32_t now = millis();
+  uint8_t due[MLX90632_MANAGER_MAX_SENSORS];
+  uint8_t num_due = 0;
+  uint8_t completed = 0;
+
+  // Collect the sensors with work due, sorted by deadline
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t d = deadline(slots[i]);
+    if ((int32_t)(now - d) < 0) {
+      continue;
+    }
+    uint8_t j = num_due++;
+    while (j > 0 && (int32_t)(deadline(slots[due[j - 1]]) - d) > 0) {
+      due[j] = due[j - 1];
+      j--;
+    }
+    due[j] = i;
+  }
+
+  for (uint8_t n = 0; n < num_due; n++) {
+    slot_t& slot = slots[due[n]];
+    mlx90632_poll_state_t before = slot.sensor->getPollState();
+
+    if (slot.select) {
+      slot.select(slot.channel);
+    }
+    mlx90632_poll_state_t state = slot.sensor->poll();
+    slot.started = true;
+
+    // poll() has no deadline for a halted sensor; look at it again one
+    // refresh period later instead of on every update()
+    slot.halted = state == MLX90632_STATE_IDLE &&
+                  slot.sensor->getMode() == MLX90632_MODE_HALT;
+    if (slot.halted) {
+      uint16_t period = slot.sensor->getRefreshPeriod();
+      slot.halted_ms = now + (period ? period : 1);
+    }
+
+    if ((before == MLX90632_STATE_IDLE || before == MLX90632_STATE_READY) &&
+        (state == MLX90632_STATE_TRIGGERED ||
+         state == MLX90632_STATE_WAITING)) {
+      // A new sample has started
+      slot.cycle_ms = now;
+    } else if (state == MLX90632_STATE_READY) {
+      uint32_t latency = now - slot.cycle_ms;
+      slot.samples++;
+      slot.latency_sum_ms += latency;
+      if (latency > slot.latency_max_ms) {
+        slot.latency_max_ms = latency;
+      }
+      total_samples++;
+      completed++;
+      if (callback) {
+        callback(due[n], slot.sensor);
+      }
+    }
+  }
+
+  return completed;
+}
+
+/*!
+ *    @brief  Get the combined output rate of all sensors since begin()
+ *    @return Samples per second across all sensors
+ */
+float Adafruit_MLX90632_Manager::getSamplesPerSecond() {
+  uint32_t elapsed = millis() - begin_ms;
+
+  if (elapsed == 0) {
+    return 0;
+  }
+  return (float)total_samples * 1000.0f / (float)elapsed;
+}
+
+/*!
+ *    @brief  Get the number of samples a sensor has completed
+ *    @param  index Sensor index
+ *    @return Number of samples since begin()
+ */
+uint32_t Adafruit_MLX90632_Manager::getSampleCount(uint8_t index) {
+  return (index < count) ? slots[index].samples : 0;
+}
+
+/*!
+ *    @brief  Get the average time from the start of a sample (trigger in
+ *            step modes, start of waiting in continuous mode) until its frame
+ *            was read
+ *    @param  index Sensor index
+ *    @return Average latency in milliseconds
+ */
+uint32_t Adafruit_MLX90632_Manager::getAverageLatency(uint8_t index) {
+  if (index >= count || slots[index].samples == 0) {
+    return 0;
+  }
+  return slots[index].latency_sum_ms / slots[index].samples;
+}
+
+/*!
+ *    @brief  Get the largest sample latency of a sensor
+ *    @param  index Sensor index
+ *    @return Maximum latency in milliseconds
+ */
+uint32_t Adafruit_MLX90632_Manager::getMaxLatency(uint8_t index) {
+  return (index < count) ? slots[index].latency_max_ms : 0;
+}
+
+/*!
+ *    @brief  Get the time a sensor next needs servicing
+ *    @param  slot Sensor slot
+ *    @return millis() value of the deadline
+ */
+uint32_t Adafruit_MLX90632_Manager::deadline(const slot_t& slot) {
+  if (!slot.started) {
+    return slot.start_ms;
+  }
+  return slot.halted ? slot.halted_ms : slot.sensor->getNextPollTime();
+}
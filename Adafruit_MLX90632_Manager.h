@@ -0,0 +1,81 @@
+/*!
+ *  @file Adafruit_MLX90632_Manager.h
+ *
+ * 	Round-robin scheduler for several MLX90632 sensors on one I2C bus
+ *
+ * 	This is a library for the Adafruit MLX90632 breakout:
+ * 	http://www.adafruit.com/products
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	MIT license, see LICENSE for more information
+ */
+
+#ifndef _ADAFRUIT_MLX90632_MANAGER_H
+#define _ADAFRUIT_MLX90632_MANAGER_H
+
+#include "Adafruit_MLX90632.h"
+
+#define MLX90632_MANAGER_MAX_SENSORS 8 ///< Sensors one manager can own
+
+/*!
+ *    @brief  Callback to route the bus to a sensor, e.g. to select a channel
+ *            on an I2C multiplexer
+ */
+typedef void (*mlx90632_bus_select_t)(uint8_t channel);
+
+/*!
+ *    @brief  Callback for each completed sample
+ */
+typedef void (*mlx90632_sample_callback_t)(uint8_t index,
+                                           Adafruit_MLX90632* sensor);
+
+/*!
+ *    @brief  Class that staggers and services several MLX90632 sensors
+ *            sharing one bus, using each sensor's non-blocking poll()
+ */
+class Adafruit_MLX90632_Manager {
+ public:
+  Adafruit_MLX90632_Manager();
+  bool addSensor(Adafruit_MLX90632* sensor,
+                 mlx90632_bus_select_t select = nullptr, uint8_t channel = 0);
+  uint8_t getSensorCount();
+  Adafruit_MLX90632* getSensor(uint8_t index);
+  void setSampleCallback(mlx90632_sample_callback_t callback);
+  void begin();
+  uint8_t update();
+  float getSamplesPerSecond();
+  uint32_t getSampleCount(uint8_t index);
+  uint32_t getAverageLatency(uint8_t index);
+  uint32_t getMaxLatency(uint8_t index);
+
+ private:
+  /*!
+   *    @brief  Per-sensor scheduling and statistics
+   */
+  typedef struct {
+    Adafruit_MLX90632* sensor;    ///< Managed sensor
+    mlx90632_bus_select_t select; ///< Bus routing callback, or nullptr
+    uint8_t channel;              ///< Channel passed to select
+    bool started;                 ///< First poll() has been issued
+    bool halted;                  ///< Last poll() found the sensor halted
+    uint32_t halted_ms;           ///< millis() to look at a halted sensor
+    uint32_t start_ms;            ///< Staggered millis() of the first poll()
+    uint32_t cycle_ms;            ///< millis() the current sample started
+    uint32_t samples;             ///< Completed samples
+    uint32_t latency_sum_ms;      ///< Sum of sample latencies
+    uint32_t latency_max_ms;      ///< Largest sample latency
+  } slot_t;
+
+  uint32_t deadline(const slot_t& slot);
+
+  slot_t slots[MLX90632_MANAGER_MAX_SENSORS]; ///< Managed sensors
+  uint8_t count;                              ///< Number of managed sensors
+  mlx90632_sample_callback_t callback;        ///< Sample callback or nullptr
+  uint32_t begin_ms;                          ///< millis() at begin()
+  uint32_t total_samples; ///< Samples completed by all sensors
+};
+
+#endif
@@ -0,0 +1,142 @@
+/*!
+ *  @file Adafruit_MLX90632_SampleRing.h
+ *
+ * 	Lock-free sample buffer for handing MLX90632 samples from an
+ * 	acquisition context to a consumer
+ *
+ * 	This is a library for the Adafruit MLX90632 breakout:
+ * 	http://www.adafruit.com/products
+ *
+ * 	Adafruit invests time and resources providing this open source code,
+ *  please support Adafruit and open-source hardware by purchasing products from
+ * 	Adafruit!
+ *
+ *	MIT license, see LICENSE for more information
+ */
+
+#ifndef _ADAFRUIT_MLX90632_SAMPLERING_H
+#define _ADAFRUIT_MLX90632_SAMPLERING_H
+
+#include "Adafruit_MLX90632.h"
+
+// Ring indices must be read and written in a single instruction
+#if defined(__AVR__)
+typedef uint8_t mlx90632_ring_index_t; ///< Index type, atomic on this CPU
+#define MLX90632_RING_MAX_SIZE 128     ///< Largest ring for the index type
+#else
+typedef uint16_t mlx90632_ring_index_t; ///< Index type, atomic on this CPU
+#define MLX90632_RING_MAX_SIZE 32768    ///< Largest ring for the index type
+#endif
+
+/*!
+ *    @brief  Fixed-capacity, statically allocated single-producer /
+ *            single-consumer ring of samples. push() may be called from an
+ *            interrupt or timer context, or from another core, while the
+ *            main loop drains with pop(); no locks or interrupt masking are
+ *            needed as long as there is exactly one producer and one
+ *            consumer. The indices are published with release stores and
+ *            read with acquire loads.
+ *    @tparam N Capacity in samples, a power of two
+ *    @tparam Index Unsigned index type, which must be atomic on the CPU.
+ *            Holds at most half its range, e.g. 128 samples for uint8_t.
+ */
+template <size_t N, typename Index = mlx90632_ring_index_t>
+class Adafruit_MLX90632_SampleRing {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+  static_assert(N <= ((size_t)(Index)~(Index)0 >> 1) + 1,
+                "N is too large for the index type");
+
+ public:
+  /*!
+   *    @brief  Instantiates an empty ring
+   */
+  Adafruit_MLX90632_SampleRing() {
+    head = 0;
+    tail = 0;
+    overruns = 0;
+  }
+
+  /*!
+   *    @brief  Add a sample. Producer side only.
+   *    @param  sample Sample to copy into the ring
+   *    @return True if stored, false if the ring was full (the sample is
+   *            dropped and counted as an overrun)
+   */
+  bool push(const mlx90632_sample_t& sample) {
+    Index h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    // The consumer is done with a slot once it has moved tail past it
+    Index t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+
+    if ((Index)(h - t) >= N) {
+      overruns++;
+      return false;
+    }
+    samples[h & (N - 1)] = sample;
+    // Publish the sample only after it has been written
+    __atomic_store_n(&head, (Index)(h + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  /*!
+   *    @brief  Remove up to max samples in one batch. Consumer side only.
+   *    @param  out Buffer for the samples, oldest first
+   *    @param  max Size of the buffer in samples
+   *    @return Number of samples copied
+   */
+  Index pop(mlx90632_sample_t* out, Index max) {
+    Index t = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+    // Samples up to head have been written completely
+    Index n = __atomic_load_n(&head, __ATOMIC_ACQUIRE) - t;
+
+    if (n > max) {
+      n = max;
+    }
+    for (Index i = 0; i < n; i++) {
+      out[i] = samples[(Index)(t + i) & (N - 1)];
+    }
+    // Release the slots only after they have been copied
+    __atomic_store_n(&tail, (Index)(t + n), __ATOMIC_RELEASE);
+    return n;
+  }
+
+  /*!
+   *    @brief  Get the number of samples waiting to be popped
+   *    @return Number of samples in the ring
+   */
+  Index available() {
+    return (Index)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) -
+                   __atomic_load_n(&tail, __ATOMIC_ACQUIRE));
+  }
+
+  /*!
+   *    @brief  Get the number of samples dropped because the ring was full
+   *    @return Overrun count
+   */
+  uint32_t getOverruns() {
+#if defined(__AVR__)
+    // Four loads on AVR: keep an interrupt-side push() from tearing them
+    uint8_t sreg = SREG;
+    noInterrupts();
+    uint32_t count = overruns;
+    SREG = sreg;
+    return count;
+#else
+    return overruns;
+#endif
+  }
+
+  /*!
+   *    @brief  Reset the overrun counter. Producer side only.
+   */
+  void resetOverruns() {
+    overruns = 0;
+  }
+
+ private:
+  mlx90632_sample_t samples[N]; ///< Sample storage
+  Index head;                   ///< Next slot to write, producer owned
+  Index tail;                   ///< Next slot to read, consumer owned
+  volatile uint32_t overruns;   ///< Samples dropped on a full ring
+};
+
+#endif
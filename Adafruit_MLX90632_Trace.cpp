@@ -0,0 +1,342 @@
+/*!
+ *  @file Adafruit_MLX90632_Trace.cpp
+ *
+ * 	Bus trace recording and replay for the MLX90632 driver, see
+ *  Adafruit_MLX90632_Trace.h for the format.
+ *
+ * 	MIT license, see LICENSE for more information
+ */
+
+#include "Adafruit_MLX90632_Trace.h"
+
+static const uint8_t trace_magic[4] = {'M', 'L', 'X', 'T'}; ///< Header start
+
+/*!
+ *    @brief  Instantiates a recorder without a buffer; it drops every record
+ *            until begin()
+ */
+Adafruit_MLX90632_TraceRecorder::Adafruit_MLX90632_TraceRecorder() {
+  buffer = nullptr;
+  size = 0;
+  length = 0;
+  flusher = nullptr;
+  flush_context = nullptr;
+  last_us = 0;
+  records = 0;
+  dropped = 0;
+}
+
+/*!
+ *    @brief  Start a new trace: write the header and restart the clock
+ *    @param  buffer Buffer the records are appended to
+ *    @param  size Capacity of the buffer, at least the header plus one
+ *            full RAM burst record
+ *    @param  flush Called with the buffer contents when it is full, or
+ *            nullptr to drop records once it is full
+ *    @param  context Passed to flush
+ *    @return True if the buffer is large enough
+ */
+bool Adafruit_MLX90632_TraceRecorder::begin(uint8_t* buffer, size_t size,
+                                            mlx90632_trace_flush_t flush,
+                                            void* context) {
+  this->buffer = nullptr;
+  if (!buffer || size < MLX90632_TRACE_HEADER + MLX90632_TRACE_OVERHEAD +
+                            2 * MLX90632_TRACE_MAX_WORDS) {
+    return false;
+  }
+
+  this->buffer = buffer;
+  this->size = size;
+  flusher = flush;
+  flush_context = context;
+  memcpy(buffer, trace_magic, sizeof(trace_magic));
+  buffer[sizeof(trace_magic)] = MLX90632_TRACE_VERSION;
+  length = MLX90632_TRACE_HEADER;
+  last_us = micros();
+  records = 0;
+  dropped = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Append one transaction. Called by the driver after each
+ *            register read or write.
+ *    @param  read True for a read, false for a write
+ *    @param  ok True if the transaction succeeded
+ *    @param  reg Register address
+ *    @param  data Big-endian payload: the words read or the value written
+ *    @param  len Payload bytes, ignored if the transaction failed
+ */
+void Adafruit_MLX90632_TraceRecorder::record(bool read, bool ok, uint16_t reg,
+                                             const uint8_t* data,
+                                             uint8_t len) {
+  uint32_t now = micros();
+  uint32_t delta = now - last_us;
+
+  if (!ok) {
+    len = 0;
+  }
+  if (!buffer || len > 2 * MLX90632_TRACE_MAX_WORDS) {
+    dropped++;
+    return;
+  }
+  if (length + MLX90632_TRACE_OVERHEAD + len > size && !flush()) {
+    dropped++;
+    return;
+  }
+
+  uint8_t* p = buffer + length;
+  *p++ = (read ? MLX90632_TRACE_READ : 0) | (ok ? 0 : MLX90632_TRACE_FAILED) |
+         (len / 2);
+  while (delta >= 0x80) {
+    *p++ = (uint8_t)(delta | 0x80);
+    delta >>= 7;
+  }
+  *p++ = (uint8_t)delta;
+  *p++ = (uint8_t)(reg >> 8);
+  *p++ = (uint8_t)(reg & 0xFF);
+  memcpy(p, data, len);
+  length = (p + len) - buffer;
+  last_us = now;
+  records++;
+}
+
+/*!
+ *    @brief  Hand the recorded bytes to the flush callback and empty the
+ *            buffer. Call it at the end of a session; the header is only
+ *            written once, at the start of the stream.
+ *    @return True if the bytes were stored (or there were none), false if
+ *            there is no flush callback or it failed
+ */
+bool Adafruit_MLX90632_TraceRecorder::flush() {
+  if (!length) {
+    return true;
+  }
+  if (!flusher || !flusher(flush_context, buffer, length)) {
+    return false;
+  }
+  length = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Get the recorded bytes not yet flushed
+ *    @return Pointer to the buffer given to begin()
+ */
+const uint8_t* Adafruit_MLX90632_TraceRecorder::getBuffer() {
+  return buffer;
+}
+
+/*!
+ *    @brief  Get the number of recorded bytes not yet flushed
+ *    @return Bytes in the buffer
+ */
+size_t Adafruit_MLX90632_TraceRecorder::getLength() {
+  return length;
+}
+
+/*!
+ *    @brief  Get the number of records appended since begin()
+ *    @return Record count
+ */
+uint32_t Adafruit_MLX90632_TraceRecorder::getRecordCount() {
+  return records;
+}
+
+/*!
+ *    @brief  Get the number of records lost because the buffer was full. A
+ *            trace with dropped records can't be replayed past the gap.
+ *    @return Dropped record count
+ */
+uint32_t Adafruit_MLX90632_TraceRecorder::getDroppedCount() {
+  return dropped;
+}
+
+/*!
+ *    @brief  Instantiates a replay without a trace
+ */
+Adafruit_MLX90632_TraceReplay::Adafruit_MLX90632_TraceReplay() {
+  trace = nullptr;
+  length = 0;
+  position = 0;
+  timestamp_us = 0;
+  records = 0;
+  mismatches = 0;
+}
+
+/*!
+ *    @brief  Start playing a trace from its first record
+ *    @param  trace Complete trace, header included
+ *    @param  len Bytes in the trace
+ *    @return True if the header is valid
+ */
+bool Adafruit_MLX90632_TraceReplay::begin(const uint8_t* trace, size_t len) {
+  this->trace = nullptr;
+  if (!trace || len < MLX90632_TRACE_HEADER ||
+      memcmp(trace, trace_magic, sizeof(trace_magic)) != 0 ||
+      trace[sizeof(trace_magic)] != MLX90632_TRACE_VERSION) {
+    return false;
+  }
+
+  this->trace = trace;
+  length = len;
+  position = MLX90632_TRACE_HEADER;
+  timestamp_us = 0;
+  records = 0;
+  mismatches = 0;
+  return true;
+}
+
+/*!
+ *    @brief  Decode the record at an offset
+ *    @param  pos Offset of the record, advanced past it on success
+ *    @param  record Record to fill, its time relative to the last record
+ *            played
+ *    @return False at the end of the trace or on a truncated record
+ */
+bool Adafruit_MLX90632_TraceReplay::decode(size_t* pos,
+                                           mlx90632_trace_record_t* record) {
+  size_t p = *pos;
+  uint32_t delta = 0;
+  uint8_t shift = 0;
+
+  if (!trace || p >= length) {
+    return false;
+  }
+  uint8_t tag = trace[p++];
+  do {
+    if (p >= length || shift > 28) {
+      return false;
+    }
+    delta |= (uint32_t)(trace[p] & 0x7F) << shift;
+    shift += 7;
+  } while (trace[p++] & 0x80);
+
+  record->read = tag & MLX90632_TRACE_READ;
+  record->ok = !(tag & MLX90632_TRACE_FAILED);
+  record->words = tag & MLX90632_TRACE_WORDS;
+  size_t len = 2 * record->words;
+  if (p + 2 + len > length) {
+    return false;
+  }
+  record->timestamp_us = timestamp_us + delta;
+  record->reg = ((uint16_t)trace[p] << 8) | trace[p + 1];
+  memcpy(record->data, trace + p + 2, len);
+  *pos = p + 2 + len;
+  return true;
+}
+
+/*!
+ *    @brief  Read the next record and move past it, e.g. to inspect or
+ *            convert a trace offline
+ *    @param  record Record to fill
+ *    @return False at the end of the trace or on a truncated record
+ */
+bool Adafruit_MLX90632_TraceReplay::next(mlx90632_trace_record_t* record) {
+  if (!decode(&position, record)) {
+    return false;
+  }
+  timestamp_us = record->timestamp_us;
+  records++;
+  return true;
+}
+
+/*!
+ *    @brief  Answer one driver transaction from the next record. The
+ *            register, direction, length and (for writes) value must match
+ *            the record; otherwise the transaction fails, the mismatch is
+ *            counted and the record is kept.
+ *    @param  write_data Bytes the driver writes: register address, then
+ *            the value for a write
+ *    @param  write_len Number of bytes written
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read, 0 for a write
+ *    @return True if the recorded transaction succeeded
+ */
+bool Adafruit_MLX90632_TraceReplay::transact(const uint8_t* write_data,
+                                             size_t write_len,
+                                             uint8_t* read_data,
+                                             size_t read_len) {
+  mlx90632_trace_record_t record;
+  size_t pos = position;
+
+  // Address probes from begin() aren't register transactions
+  if (write_len == 0 && read_len == 0) {
+    return true;
+  }
+
+  bool read = read_len > 0;
+  size_t len = read ? read_len : write_len - 2;
+  if (write_len < 2 || !decode(&pos, &record) || record.read != read ||
+      record.reg != (((uint16_t)write_data[0] << 8) | write_data[1]) ||
+      (record.ok && 2u * record.words != len) ||
+      (record.ok && !read && memcmp(record.data, write_data + 2, len) != 0)) {
+    mismatches++;
+    return false;
+  }
+
+  position = pos;
+  timestamp_us = record.timestamp_us;
+  records++;
+  if (read && record.ok) {
+    memcpy(read_data, record.data, len);
+  }
+  return record.ok;
+}
+
+/*!
+ *    @brief  Mock bus handler, see mlx90632_mock_bus_t. Set the bus context
+ *            to the replay.
+ *    @param  context The Adafruit_MLX90632_TraceReplay
+ *    @param  addr Device address, not recorded in the trace
+ *    @param  write_data Bytes written
+ *    @param  write_len Number of bytes written
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read
+ *    @return The result of transact()
+ */
+bool Adafruit_MLX90632_TraceReplay::handler(void* context, uint8_t addr,
+                                            const uint8_t* write_data,
+                                            size_t write_len,
+                                            uint8_t* read_data,
+                                            size_t read_len) {
+  (void)addr;
+  return static_cast<Adafruit_MLX90632_TraceReplay*>(context)->transact(
+      write_data, write_len, read_data, read_len);
+}
+
+/*!
+ *    @brief  Check whether every record has been played
+ *    @return True at the end of the trace
+ */
+bool Adafruit_MLX90632_TraceReplay::atEnd() {
+  return !trace || position >= length;
+}
+
+/*!
+ *    @brief  Get the recorded time of the last record played. A replay
+ *            harness can advance its clock to it so that the driver's
+ *            millis()-based scheduling follows the recorded timeline.
+ *    @return Microseconds since the recorder's begin()
+ */
+uint64_t Adafruit_MLX90632_TraceReplay::getTimestamp() {
+  return timestamp_us;
+}
+
+/*!
+ *    @brief  Get the number of records played
+ *    @return Record count
+ */
+uint32_t Adafruit_MLX90632_TraceReplay::getRecordCount() {
+  return records;
+}
+
+/*!
+ *    @brief  Get the number of driver transactions that didn't match the
+ *            next record, e.g. because the driver under test polls
+ *            differently from the recorded one
+ *    @return Mismatch count
+ */
+uint32_t Adafruit_MLX90632_TraceReplay::getMismatchCount() {
+  return mismatches;
+}
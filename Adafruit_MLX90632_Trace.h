@@ -0,0 +1,118 @@
+/*!
+ *  @file Adafruit_MLX90632_Trace.h
+ *
+ * 	Bus trace recording and replay for the MLX90632 driver
+ *
+ *  A trace is an append-only byte stream: a 5-byte header ("MLXT" and the
+ *  format version) followed by one record per register transaction:
+ *
+ *  - tag byte: bit 7 set for a read, bit 6 set if the transaction failed,
+ *    bits 5:0 the number of 16-bit payload words (0 if it failed)
+ *  - time since the previous record (or since begin()) in microseconds,
+ *    as an unsigned LEB128 varint
+ *  - register address, big-endian
+ *  - payload words, big-endian as on the wire: the value written, or the
+ *    words read
+ *
+ *  A status read takes 7 bytes and a medical RAM burst 17, when the
+ *  time since the previous record is below 16 ms.
+ *
+ * 	MIT license, see LICENSE for more information
+ */
+
+#ifndef _ADAFRUIT_MLX90632_TRACE_H
+#define _ADAFRUIT_MLX90632_TRACE_H
+
+#include "Arduino.h"
+
+#define MLX90632_TRACE_VERSION 1    ///< Format version in the header
+#define MLX90632_TRACE_HEADER 5     ///< Header bytes
+#define MLX90632_TRACE_MAX_WORDS 63 ///< Payload words a record can hold
+#define MLX90632_TRACE_READ 0x80    ///< Tag bit: read transaction
+#define MLX90632_TRACE_FAILED 0x40  ///< Tag bit: transaction failed
+#define MLX90632_TRACE_WORDS 0x3F   ///< Tag bits: payload words
+#define MLX90632_TRACE_OVERHEAD 8   ///< Largest record without payload
+
+/*!
+ *    @brief  Called when the recorder's buffer is full, e.g. to append it
+ *            to a file on SD
+ *    @param  context The context given to begin()
+ *    @param  data Bytes recorded since the last flush
+ *    @param  len Number of bytes
+ *    @return True if the bytes were stored, false to drop them
+ */
+typedef bool (*mlx90632_trace_flush_t)(void* context, const uint8_t* data,
+                                       size_t len);
+
+/*!
+ *    @brief  One decoded trace record
+ */
+typedef struct {
+  uint64_t timestamp_us;                      ///< Microseconds since start
+  uint16_t reg;                               ///< Register address
+  bool read;                                  ///< Read (true) or write (false)
+  bool ok;                                    ///< The transaction succeeded
+  uint8_t words;                              ///< Payload words
+  uint8_t data[2 * MLX90632_TRACE_MAX_WORDS]; ///< Payload, big-endian
+} mlx90632_trace_record_t;
+
+/*!
+ *    @brief  Appends every register transaction of a driver to a trace, see
+ *            Adafruit_MLX90632::setTrace()
+ */
+class Adafruit_MLX90632_TraceRecorder {
+ public:
+  Adafruit_MLX90632_TraceRecorder();
+  bool begin(uint8_t* buffer, size_t size,
+             mlx90632_trace_flush_t flush = nullptr, void* context = nullptr);
+  void record(bool read, bool ok, uint16_t reg, const uint8_t* data,
+              uint8_t len);
+  bool flush();
+  const uint8_t* getBuffer();
+  size_t getLength();
+  uint32_t getRecordCount();
+  uint32_t getDroppedCount();
+
+ private:
+  uint8_t* buffer;                ///< Trace bytes not yet flushed
+  size_t size;                    ///< Capacity of buffer
+  size_t length;                  ///< Bytes in buffer
+  mlx90632_trace_flush_t flusher; ///< Called when buffer is full
+  void* flush_context;            ///< For flusher
+  uint32_t last_us;               ///< micros() of the previous record
+  uint32_t records;               ///< Records appended
+  uint32_t dropped;               ///< Records lost to a full buffer
+};
+
+/*!
+ *    @brief  Plays a trace back to a driver. handler() answers each
+ *            transaction from the next record, so a driver built with the
+ *            mock transport sees the recorded status bits, cycle positions
+ *            and RAM words in the same order, without waiting for the bus.
+ */
+class Adafruit_MLX90632_TraceReplay {
+ public:
+  Adafruit_MLX90632_TraceReplay();
+  bool begin(const uint8_t* trace, size_t len);
+  bool next(mlx90632_trace_record_t* record);
+  bool transact(const uint8_t* write_data, size_t write_len,
+                uint8_t* read_data, size_t read_len);
+  static bool handler(void* context, uint8_t addr, const uint8_t* write_data,
+                      size_t write_len, uint8_t* read_data, size_t read_len);
+  bool atEnd();
+  uint64_t getTimestamp();
+  uint32_t getRecordCount();
+  uint32_t getMismatchCount();
+
+ private:
+  bool decode(size_t* pos, mlx90632_trace_record_t* record);
+
+  const uint8_t* trace;  ///< Trace being played
+  size_t length;         ///< Bytes in trace
+  size_t position;       ///< Offset of the next record
+  uint64_t timestamp_us; ///< Time of the last record played
+  uint32_t records;      ///< Records played
+  uint32_t mismatches;   ///< Transactions that didn't match the trace
+};
+
+#endif
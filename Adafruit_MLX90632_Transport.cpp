@@ -0,0 +1,383 @@
+/*!
+ *  @file Adafruit_MLX90632_Transport.cpp
+ *
+ * 	I2C transports for the MLX90632 driver, see
+ *  Adafruit_MLX90632_Transport.h. Only the transport selected with
+ *  MLX90632_TRANSPORT is compiled.
+ *
+ * 	MIT license, see LICENSE for more information
+ */
+
+#include "Adafruit_MLX90632.h"
+
+/*!
+ *    @brief  Record the result of a descriptor and call its completion
+ *    @param  xfer Descriptor whose transaction just ended
+ *    @param  ok True if the transaction succeeded
+ *    @return The descriptor to run next, nullptr if the chain ended
+ */
+static mlx90632_xfer_t* completeXfer(mlx90632_xfer_t* xfer, bool ok) {
+  xfer->ok = ok;
+  if (xfer->complete ? !xfer->complete(xfer) : !ok) {
+    return nullptr;
+  }
+  return xfer->next;
+}
+
+/*!
+ *    @brief  Run a descriptor chain to the end on a blocking transport
+ *    @tparam TRANSPORT The transport class
+ *    @param  transport Transport to run the transactions on
+ *    @param  addr 7-bit device address
+ *    @param  xfer First descriptor
+ *    @return Always true, the chain has completed
+ */
+template <typename TRANSPORT>
+static bool runChain(TRANSPORT* transport, uint8_t addr,
+                     mlx90632_xfer_t* xfer) {
+  while (xfer) {
+    bool ok;
+
+    xfer->addr = addr;
+    if (xfer->rx_len) {
+      ok = transport->writeThenRead(xfer->tx, xfer->tx_len, xfer->rx,
+                                    xfer->rx_len);
+    } else {
+      ok = transport->write(xfer->tx, xfer->tx_len);
+    }
+    xfer = completeXfer(xfer, ok);
+  }
+  return true;
+}
+
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_WIRE
+
+/*!
+ *    @brief  Instantiates a transport that is not bound to a bus yet
+ */
+Adafruit_MLX90632_WireTransport::Adafruit_MLX90632_WireTransport() {
+  wire = nullptr;
+  addr = 0;
+}
+
+/*!
+ *    @brief  Start the bus and probe the device address
+ *    @param  addr 7-bit device address
+ *    @param  wire The Wire object the device sits on
+ *    @return True if the device acknowledged its address
+ */
+bool Adafruit_MLX90632_WireTransport::begin(uint8_t addr, TwoWire* wire) {
+  this->addr = addr;
+  this->wire = wire;
+  wire->begin();
+
+  wire->beginTransmission(addr);
+  return wire->endTransmission() == 0;
+}
+
+/*!
+ *    @brief  Write bytes in one transfer ending with a stop
+ *    @param  data Bytes to write
+ *    @param  len Number of bytes
+ *    @return True if the device acknowledged every byte
+ */
+bool Adafruit_MLX90632_WireTransport::write(const uint8_t* data, size_t len) {
+  return transmit(data, len, true);
+}
+
+/*!
+ *    @brief  Write bytes, then read with a repeated start
+ *    @param  write_data Bytes to write, the register address
+ *    @param  write_len Number of bytes to write
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read, at most maxBufferSize()
+ *    @return True if the whole transaction succeeded
+ */
+bool Adafruit_MLX90632_WireTransport::writeThenRead(const uint8_t* write_data,
+                                                    size_t write_len,
+                                                    uint8_t* read_data,
+                                                    size_t read_len) {
+  if (read_len > maxBufferSize() || read_len > 0xFF ||
+      !transmit(write_data, write_len, false)) {
+    return false;
+  }
+  // AVR declares requestFrom() for (uint8_t, uint8_t, uint8_t) and
+  // (int, int, int), so the arguments must match one of them exactly
+#if defined(ARDUINO_ARCH_MEGAAVR)
+  size_t received = wire->requestFrom(addr, read_len, true);
+#else
+  size_t received =
+      wire->requestFrom((uint8_t)addr, (uint8_t)read_len, (uint8_t) true);
+#endif
+  if (received != read_len) {
+    return false;
+  }
+  for (size_t i = 0; i < read_len; i++) {
+    read_data[i] = (uint8_t)wire->read();
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Run a descriptor chain. Arduino Wire has no portable
+ *            non-blocking API, so the chain and its completions run before
+ *            this returns.
+ *    @param  chain First descriptor
+ *    @return True, the chain has completed
+ */
+bool Adafruit_MLX90632_WireTransport::submit(mlx90632_xfer_t* chain) {
+  return runChain(this, addr, chain);
+}
+
+/*!
+ *    @brief  Send one write transfer
+ *    @param  data Bytes to write
+ *    @param  len Number of bytes, at most maxBufferSize()
+ *    @param  stop False to keep the bus for a repeated start
+ *    @return True if the device acknowledged every byte
+ */
+bool Adafruit_MLX90632_WireTransport::transmit(const uint8_t* data, size_t len,
+                                               bool stop) {
+  if (len > maxBufferSize()) {
+    return false;
+  }
+  wire->beginTransmission(addr);
+  if (wire->write(data, len) != len) {
+    return false;
+  }
+  return wire->endTransmission(stop) == 0;
+}
+
+#elif MLX90632_TRANSPORT == MLX90632_TRANSPORT_LINUX
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/*!
+ *    @brief  Instantiates a transport without an open adapter
+ */
+Adafruit_MLX90632_LinuxTransport::Adafruit_MLX90632_LinuxTransport() {
+  fd = -1;
+  addr = 0;
+}
+
+/*!
+ *    @brief  Closes the adapter
+ */
+Adafruit_MLX90632_LinuxTransport::~Adafruit_MLX90632_LinuxTransport() {
+  close();
+}
+
+/*!
+ *    @brief  Open an i2c-dev adapter and check that it can do I2C_RDWR.
+ *            SMBus-only adapters can't issue the combined transaction a
+ *            burst read needs and are refused. The device itself is only
+ *            checked by the first register read.
+ *    @param  addr 7-bit device address
+ *    @param  device Adapter path, e.g. "/dev/i2c-1"
+ *    @return True if the adapter is open and supports plain I2C messages
+ */
+bool Adafruit_MLX90632_LinuxTransport::begin(uint8_t addr,
+                                             const char* device) {
+  unsigned long funcs = 0;
+
+  close();
+  this->addr = addr;
+  fd = ::open(device, O_RDWR);
+  if (fd < 0) {
+    return false;
+  }
+  if (ioctl(fd, I2C_FUNCS, &funcs) < 0 || !(funcs & I2C_FUNC_I2C)) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Write bytes in one message
+ *    @param  data Bytes to write
+ *    @param  len Number of bytes
+ *    @return True if the device acknowledged every byte
+ */
+bool Adafruit_MLX90632_LinuxTransport::write(const uint8_t* data, size_t len) {
+  struct i2c_msg msg = {addr, 0, (__u16)len, const_cast<__u8*>(data)};
+  struct i2c_rdwr_ioctl_data xfer = {&msg, 1};
+
+  return fd >= 0 && ioctl(fd, I2C_RDWR, &xfer) == 1;
+}
+
+/*!
+ *    @brief  Write bytes, then read with a repeated start, in one ioctl
+ *    @param  write_data Bytes to write, the register address
+ *    @param  write_len Number of bytes to write
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read, at most maxBufferSize()
+ *    @return True if the whole transaction succeeded
+ */
+bool Adafruit_MLX90632_LinuxTransport::writeThenRead(const uint8_t* write_data,
+                                                     size_t write_len,
+                                                     uint8_t* read_data,
+                                                     size_t read_len) {
+  struct i2c_msg msgs[2] = {
+      {addr, 0, (__u16)write_len, const_cast<__u8*>(write_data)},
+      {addr, I2C_M_RD, (__u16)read_len, read_data}};
+  struct i2c_rdwr_ioctl_data xfer = {msgs, 2};
+
+  if (read_len > maxBufferSize()) {
+    return false;
+  }
+  return fd >= 0 && ioctl(fd, I2C_RDWR, &xfer) == 2;
+}
+
+/*!
+ *    @brief  Run a descriptor chain. i2c-dev blocks in the ioctl, so the
+ *            chain and its completions run before this returns.
+ *    @param  chain First descriptor
+ *    @return True, the chain has completed
+ */
+bool Adafruit_MLX90632_LinuxTransport::submit(mlx90632_xfer_t* chain) {
+  return runChain(this, addr, chain);
+}
+
+/*!
+ *    @brief  Largest read that fits in one transfer. i2c-dev takes much
+ *            longer messages; this is the longest burst the driver issues.
+ *    @return Size in bytes
+ */
+size_t Adafruit_MLX90632_LinuxTransport::maxBufferSize() {
+  return 2 * MLX90632_MAX_BURST_WORDS;
+}
+
+/*!
+ *    @brief  Close the adapter if it is open
+ */
+void Adafruit_MLX90632_LinuxTransport::close() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+#elif MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+
+/*!
+ *    @brief  Instantiates a transport that is not bound to a bus yet
+ */
+Adafruit_MLX90632_MockTransport::Adafruit_MLX90632_MockTransport() {
+  bus = nullptr;
+  addr = 0;
+}
+
+/*!
+ *    @brief  Bind to a mock bus and probe the device address
+ *    @param  addr 7-bit device address
+ *    @param  bus Handler and context, must outlive the driver
+ *    @return True if the handler acknowledged the probe
+ */
+bool Adafruit_MLX90632_MockTransport::begin(uint8_t addr,
+                                            mlx90632_mock_bus_t* bus) {
+  this->addr = addr;
+  this->bus = bus;
+  if (!bus || !bus->handler) {
+    return false;
+  }
+  return bus->handler(bus->context, addr, nullptr, 0, nullptr, 0);
+}
+
+/*!
+ *    @brief  Hand a write to the handler
+ *    @param  data Bytes to write
+ *    @param  len Number of bytes
+ *    @return The handler's result
+ */
+bool Adafruit_MLX90632_MockTransport::write(const uint8_t* data, size_t len) {
+  return bus->handler(bus->context, addr, data, len, nullptr, 0);
+}
+
+/*!
+ *    @brief  Hand a write-then-read to the handler
+ *    @param  write_data Bytes to write, the register address
+ *    @param  write_len Number of bytes to write
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read, at most maxBufferSize()
+ *    @return The handler's result
+ */
+bool Adafruit_MLX90632_MockTransport::writeThenRead(const uint8_t* write_data,
+                                                    size_t write_len,
+                                                    uint8_t* read_data,
+                                                    size_t read_len) {
+  if (read_len > maxBufferSize()) {
+    return false;
+  }
+  return bus->handler(bus->context, addr, write_data, write_len, read_data,
+                      read_len);
+}
+
+/*!
+ *    @brief  Run a descriptor chain. On a deferred bus the chain is only
+ *            queued and completeNext() runs it; otherwise it runs to the
+ *            end before this returns.
+ *    @param  chain First descriptor
+ *    @return True if the chain was queued or has completed, false if the
+ *            deferred bus already holds MLX90632_MOCK_QUEUE chains
+ */
+bool Adafruit_MLX90632_MockTransport::submit(mlx90632_xfer_t* chain) {
+  if (!bus->deferred) {
+    return runChain(this, addr, chain);
+  }
+  if (bus->queue_count >= MLX90632_MOCK_QUEUE) {
+    return false;
+  }
+  for (mlx90632_xfer_t* xfer = chain; xfer; xfer = xfer->next) {
+    xfer->addr = addr;
+  }
+  bus->queue[(bus->queue_head + bus->queue_count) % MLX90632_MOCK_QUEUE] =
+      chain;
+  bus->queue_count++;
+  return true;
+}
+
+/*!
+ *    @brief  Run the next descriptor queued on a deferred bus and call its
+ *            completion, as a DMA completion interrupt would. Chains take
+ *            turns, one descriptor each.
+ *    @param  bus Deferred mock bus
+ *    @return True if a descriptor ran, false if nothing was queued
+ */
+bool Adafruit_MLX90632_MockTransport::completeNext(mlx90632_mock_bus_t* bus) {
+  if (!bus->queue_count) {
+    return false;
+  }
+  mlx90632_xfer_t* xfer = bus->queue[bus->queue_head];
+  bool ok = bus->handler(bus->context, xfer->addr, xfer->tx, xfer->tx_len,
+                         xfer->rx, xfer->rx_len);
+
+  // Take the chain off the queue before its completion may submit another
+  bus->queue_head = (bus->queue_head + 1) % MLX90632_MOCK_QUEUE;
+  bus->queue_count--;
+  xfer = completeXfer(xfer, ok);
+  if (xfer) {
+    bus->queue[(bus->queue_head + bus->queue_count) % MLX90632_MOCK_QUEUE] =
+        xfer;
+    bus->queue_count++;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Largest read that fits in one transfer
+ *    @return The bus's max_buffer_size, or the longest burst the driver
+ *            issues if that is 0
+ */
+size_t Adafruit_MLX90632_MockTransport::maxBufferSize() {
+  if (bus && bus->max_buffer_size) {
+    return bus->max_buffer_size;
+  }
+  return 2 * MLX90632_MAX_BURST_WORDS;
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*!
+ *  @file Adafruit_MLX90632_Transport.h
+ *
+ * 	I2C transports for the MLX90632 driver
+ *
+ *  The transport is picked at compile time with MLX90632_TRANSPORT and is
+ *  held by value inside Adafruit_MLX90632, so register accesses are direct
+ *  calls: no virtual dispatch and no heap allocation. Every transport has
+ *  the same five members:
+ *
+ *  - begin(addr, bus): bind to a device on a bus and check the bus is usable
+ *  - write(data, len): one write transfer ending with a stop
+ *  - writeThenRead(wdata, wlen, rdata, rlen): a write, a repeated start and
+ *    a read, as one combined transaction
+ *  - maxBufferSize(): the largest read that fits in one transfer
+ *  - submit(chain): run a chain of mlx90632_xfer_t descriptors. A DMA- or
+ *    interrupt-driven transport returns at once and completes the
+ *    descriptors later; the blocking ones run the chain before returning.
+ *
+ * 	MIT license, see LICENSE for more information
+ */
+
+#ifndef _ADAFRUIT_MLX90632_TRANSPORT_H
+#define _ADAFRUIT_MLX90632_TRANSPORT_H
+
+#include "Arduino.h"
+
+#define MLX90632_TRANSPORT_WIRE 0  ///< Arduino TwoWire
+#define MLX90632_TRANSPORT_LINUX 1 ///< Linux /dev/i2c-N with I2C_RDWR
+#define MLX90632_TRANSPORT_MOCK 2  ///< In-memory handler function
+
+#ifndef MLX90632_TRANSPORT
+#define MLX90632_TRANSPORT \
+  MLX90632_TRANSPORT_WIRE ///< Transport the driver is built with
+#endif
+
+struct mlx90632_xfer;
+
+/*!
+ *    @brief  Called by the transport after a descriptor's transaction
+ *    @param  xfer The descriptor, with ok set
+ *    @return True to go on with the next descriptor, false to stop the chain
+ */
+typedef bool (*mlx90632_xfer_complete_t)(struct mlx90632_xfer* xfer);
+
+/*!
+ *    @brief  One register transaction of an asynchronous descriptor chain.
+ *            The transport runs the descriptors in order, sets ok and calls
+ *            complete() after each one; complete() may fill in later
+ *            descriptors from the data just read.
+ */
+typedef struct mlx90632_xfer {
+  uint8_t addr;   ///< 7-bit device address, set by submit()
+  uint8_t tx[4];  ///< Register address, then the value for a write
+  uint8_t tx_len; ///< 2 for a read, 4 for a write
+  uint8_t* rx;    ///< Buffer for a read, nullptr for a write
+  uint8_t rx_len; ///< Bytes to read, 0 for a write
+  bool ok;        ///< Result, set before complete() is called
+  mlx90632_xfer_complete_t complete; ///< nullptr stops the chain on failure
+  void* context;                     ///< For complete()
+  struct mlx90632_xfer* next; ///< Next descriptor, nullptr ends the chain
+} mlx90632_xfer_t;
+
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_WIRE
+
+#include <Wire.h>
+
+#ifndef MLX90632_WIRE_BUFFER_SIZE
+#if defined(ARDUINO_ARCH_SAMD)
+#define MLX90632_WIRE_BUFFER_SIZE 250 ///< SAMD Wire ring buffer
+#elif defined(ESP32)
+#define MLX90632_WIRE_BUFFER_SIZE I2C_BUFFER_LENGTH ///< ESP32 Wire buffer
+#else
+#define MLX90632_WIRE_BUFFER_SIZE 32 ///< AVR Wire buffer
+#endif
+#endif
+
+/*!
+ *    @brief  Transport over an Arduino TwoWire bus
+ */
+class Adafruit_MLX90632_WireTransport {
+ public:
+  Adafruit_MLX90632_WireTransport();
+  bool begin(uint8_t addr, TwoWire* wire);
+  bool write(const uint8_t* data, size_t len);
+  bool writeThenRead(const uint8_t* write_data, size_t write_len,
+                     uint8_t* read_data, size_t read_len);
+  bool submit(mlx90632_xfer_t* chain);
+  /*! @brief Largest read that fits in one transfer
+   *  @return The Wire buffer size in bytes */
+  size_t maxBufferSize() {
+    return MLX90632_WIRE_BUFFER_SIZE;
+  }
+
+ private:
+  bool transmit(const uint8_t* data, size_t len, bool stop);
+
+  TwoWire* wire; ///< Bus the device sits on
+  uint8_t addr;  ///< 7-bit device address
+};
+
+typedef Adafruit_MLX90632_WireTransport
+    mlx90632_transport_t;            ///< Transport held by the driver
+typedef TwoWire mlx90632_bus_t;      ///< What begin() takes as the bus
+#define MLX90632_DEFAULT_BUS (&Wire) ///< Bus when begin() is given none
+
+#elif MLX90632_TRANSPORT == MLX90632_TRANSPORT_LINUX
+
+#define MLX90632_LINUX_DEFAULT_DEVICE \
+  "/dev/i2c-1" ///< I2C adapter on a Raspberry Pi header
+
+/*!
+ *    @brief  Transport over a Linux i2c-dev adapter. Reads are one I2C_RDWR
+ *            ioctl with a write and a read message, so the register address
+ *            and the data go out as a single combined transaction.
+ */
+class Adafruit_MLX90632_LinuxTransport {
+ public:
+  Adafruit_MLX90632_LinuxTransport();
+  ~Adafruit_MLX90632_LinuxTransport();
+  Adafruit_MLX90632_LinuxTransport(const Adafruit_MLX90632_LinuxTransport&) =
+      delete;
+  Adafruit_MLX90632_LinuxTransport&
+  operator=(const Adafruit_MLX90632_LinuxTransport&) = delete;
+
+  bool begin(uint8_t addr, const char* device);
+  bool write(const uint8_t* data, size_t len);
+  bool writeThenRead(const uint8_t* write_data, size_t write_len,
+                     uint8_t* read_data, size_t read_len);
+  bool submit(mlx90632_xfer_t* chain);
+  size_t maxBufferSize();
+
+ private:
+  void close();
+
+  int fd;       ///< Open adapter, -1 if none
+  uint8_t addr; ///< 7-bit device address
+};
+
+typedef Adafruit_MLX90632_LinuxTransport
+    mlx90632_transport_t;          ///< Transport held by the driver
+typedef const char mlx90632_bus_t; ///< What begin() takes as the bus
+#define MLX90632_DEFAULT_BUS \
+  MLX90632_LINUX_DEFAULT_DEVICE ///< Bus when begin() is given none
+
+#elif MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+
+#define MLX90632_MOCK_QUEUE 4 ///< Chains a deferred mock bus holds
+
+/*!
+ *    @brief  Handles one transaction on a mock bus. write_len 0 and
+ *            read_len 0 is an address probe, read_len 0 a plain write, and
+ *            anything else a write, a repeated start and a read.
+ *    @param  context The context of the mlx90632_mock_bus_t
+ *    @param  addr 7-bit device address
+ *    @param  write_data Bytes written
+ *    @param  write_len Number of bytes written
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read
+ *    @return True if the device acknowledged, false to fail the transaction
+ */
+typedef bool (*mlx90632_mock_handler_t)(void* context, uint8_t addr,
+                                        const uint8_t* write_data,
+                                        size_t write_len, uint8_t* read_data,
+                                        size_t read_len);
+
+/*!
+ *    @brief  An in-memory bus: a handler and its context. A deferred bus
+ *            only queues submitted chains, and completeNext() runs them one
+ *            descriptor at a time, like a DMA completion interrupt would.
+ */
+typedef struct {
+  mlx90632_mock_handler_t handler; ///< Called for every transaction
+  void* context;                   ///< Passed to the handler
+  size_t max_buffer_size; ///< Largest read per transaction, 0 for 64 bytes
+  bool deferred;          ///< Queue chains instead of running them in submit()
+  mlx90632_xfer_t* queue[MLX90632_MOCK_QUEUE]; ///< Next descriptor per chain
+  uint8_t queue_head;                          ///< Oldest chain in queue
+  uint8_t queue_count;                         ///< Chains in queue
+} mlx90632_mock_bus_t;
+
+/*!
+ *    @brief  Transport that hands every transaction to a function
+ */
+class Adafruit_MLX90632_MockTransport {
+ public:
+  Adafruit_MLX90632_MockTransport();
+  bool begin(uint8_t addr, mlx90632_mock_bus_t* bus);
+  bool write(const uint8_t* data, size_t len);
+  bool writeThenRead(const uint8_t* write_data, size_t write_len,
+                     uint8_t* read_data, size_t read_len);
+  bool submit(mlx90632_xfer_t* chain);
+  size_t maxBufferSize();
+  static bool completeNext(mlx90632_mock_bus_t* bus);
+
+ private:
+  mlx90632_mock_bus_t* bus; ///< Bus the device sits on, not owned
+  uint8_t addr;             ///< 7-bit device address
+};
+
+typedef Adafruit_MLX90632_MockTransport
+    mlx90632_transport_t;                   ///< Transport held by the driver
+typedef mlx90632_mock_bus_t mlx90632_bus_t; ///< What begin() takes as the bus
+#define MLX90632_DEFAULT_BUS nullptr        ///< The mock bus must be given
+
+#else
+#error "Unknown MLX90632_TRANSPORT"
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+// Throughput of the MLX90632 temperature conversion: per-frame
+// computeAmbient()/computeObject() against computeBatch() over an array of
+// stored frames. The sensor is only needed once, for its calibration and a
+// real frame to convert.
+
+#include <Adafruit_MLX90632.h>
+
+#define FRAMES 32
+#define REPEATS 20
+
+Adafruit_MLX90632 mlx = Adafruit_MLX90632();
+
+mlx90632_frame_t frames[FRAMES];
+mlx90632_real_t ambient[FRAMES];
+mlx90632_real_t object[FRAMES];
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("MLX90632 batch conversion benchmark"));
+
+  if (!mlx.begin()) {
+    Serial.println(F("Failed to find MLX90632 chip"));
+    while (1) { delay(10); }
+  }
+
+  mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL);
+  mlx.setMode(MLX90632_MODE_CONTINUOUS);
+  delay(mlx.getRefreshPeriod() * 2);
+
+  mlx90632_frame_t frame;
+  if (!mlx.readFrame(&frame)) {
+    Serial.println(F("Frame read failed"));
+    while (1) { delay(10); }
+  }
+
+  // Replay the captured frame, alternating the medical half-cycles
+  for (uint16_t i = 0; i < FRAMES; i++) {
+    frames[i] = frame;
+    frames[i].cycle_position = (i & 1) + 1;
+  }
+
+  const mlx90632_calibration_t& cal = mlx.getCalibration();
+  mlx90632_solver_t solver;
+
+  Adafruit_MLX90632::initSolver(&solver);
+  uint32_t start = micros();
+  for (uint16_t r = 0; r < REPEATS; r++) {
+    for (uint16_t i = 0; i < FRAMES; i++) {
+      ambient[i] = Adafruit_MLX90632::computeAmbient(frames[i], cal);
+      object[i] = Adafruit_MLX90632::computeObject(frames[i], cal, &solver);
+    }
+  }
+  uint32_t scalar_us = micros() - start;
+
+  Adafruit_MLX90632::initSolver(&solver);
+  start = micros();
+  for (uint16_t r = 0; r < REPEATS; r++) {
+    Adafruit_MLX90632::computeBatch(frames, FRAMES, cal, &solver, ambient,
+                                    object);
+  }
+  uint32_t batch_us = micros() - start;
+
+  Serial.print(F("Per frame: "));
+  printResult(scalar_us);
+  Serial.print(F("Batch:     "));
+  printResult(batch_us);
+  Serial.print(F("Last sample: ambient "));
+  Serial.print(ambient[FRAMES - 1], 4);
+  Serial.print(F(" °C, object "));
+  Serial.print(object[FRAMES - 1], 4);
+  Serial.println(F(" °C"));
+}
+
+void printResult(uint32_t us) {
+  Serial.print((float)FRAMES * REPEATS * 1e6 / us, 0);
+  Serial.print(F(" frames/s, "));
+  Serial.print((float)us / (FRAMES * REPEATS), 2);
+  Serial.println(F(" us/frame"));
+}
+
+void loop() {
+  delay(1000);
+}
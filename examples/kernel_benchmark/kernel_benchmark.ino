@@ -0,0 +1,62 @@
+// Micro-benchmark of the fourth power / fourth root used by the MLX90632
+// object temperature calculation: libm pow() against two squarings and two
+// square roots. Needs no sensor attached.
+
+#include <Arduino.h>
+#include <math.h>
+
+#define ITERATIONS 1000
+
+// volatile so the compiler can't hoist the math out of the loops
+volatile double input = 303.15;
+volatile double sink;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("MLX90632 kernel benchmark"));
+
+  // libm: pow(TAK, 4) and pow(TO_K4, 0.25)
+  uint32_t start = micros();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    double tak4 = pow(input, 4);
+    sink = pow(tak4 * 1.01, 0.25);
+  }
+  uint32_t pow_us = micros() - start;
+
+  // Driver kernel: two squarings and two square roots
+  start = micros();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    double tak2 = input * input;
+    double tak4 = tak2 * tak2;
+    sink = sqrt(sqrt(tak4 * 1.01));
+  }
+  uint32_t sqrt_us = micros() - start;
+
+  double ref = pow(pow(input, 4) * 1.01, 0.25);
+  double x2 = input * input;
+  double fast = sqrt(sqrt(x2 * x2 * 1.01));
+
+  Serial.print(F("pow():  "));
+  printResult(pow_us);
+  Serial.print(F("sqrt(): "));
+  printResult(sqrt_us);
+  Serial.print(F("Speedup: "));
+  Serial.print((float)pow_us / (float)sqrt_us, 2);
+  Serial.println(F("x"));
+  Serial.print(F("Difference: "));
+  Serial.print(fabs(ref - fast) * 1e9, 3);
+  Serial.println(F(" nK"));
+}
+
+void printResult(uint32_t us) {
+  Serial.print((float)us / ITERATIONS, 3);
+  Serial.print(F(" us/sample, "));
+  Serial.print((float)us / ITERATIONS * (F_CPU / 1000000UL), 0);
+  Serial.println(F(" cycles/sample"));
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,69 @@
+// Round-robin reading of two MLX90632 sensors sharing one I2C bus.
+// The second sensor must have been moved to another address through
+// MLX90632_REG_EE_I2C_ADDRESS, or sit behind a multiplexer (see select()).
+
+#include "Adafruit_MLX90632_Manager.h"
+
+Adafruit_MLX90632 mlx0 = Adafruit_MLX90632();
+Adafruit_MLX90632 mlx1 = Adafruit_MLX90632();
+Adafruit_MLX90632_Manager manager = Adafruit_MLX90632_Manager();
+
+uint32_t lastReport = 0;
+
+void printSample(uint8_t index, Adafruit_MLX90632* sensor) {
+  Serial.print(F("Sensor "));
+  Serial.print(index);
+  Serial.print(F(": ambient "));
+  Serial.print(sensor->getLastAmbientTemperature(), 2);
+  Serial.print(F(" °C, object "));
+  Serial.print(sensor->getLastObjectTemperature(), 2);
+  Serial.println(F(" °C"));
+}
+
+void setupSensor(Adafruit_MLX90632& mlx, uint8_t addr) {
+  if (!mlx.begin(addr)) {
+    Serial.print(F("Failed to find MLX90632 at 0x"));
+    Serial.println(addr, HEX);
+    while (1) { delay(10); }
+  }
+  mlx.setMode(MLX90632_MODE_STEP);
+  mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL);
+  mlx.setRefreshRate(MLX90632_REFRESH_4HZ);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+
+  Serial.println(F("Adafruit MLX90632 multi-sensor test"));
+
+  setupSensor(mlx0, 0x3A);
+  setupSensor(mlx1, 0x3B);
+
+  manager.addSensor(&mlx0);
+  manager.addSensor(&mlx1);
+  manager.setSampleCallback(printSample);
+  manager.begin();
+}
+
+void loop() {
+  manager.update();
+
+  // Other work can run here, update() never blocks
+
+  if (millis() - lastReport >= 5000) {
+    lastReport = millis();
+    Serial.print(F("Throughput: "));
+    Serial.print(manager.getSamplesPerSecond(), 2);
+    Serial.println(F(" samples/s"));
+    for (uint8_t i = 0; i < manager.getSensorCount(); i++) {
+      Serial.print(F("  Sensor "));
+      Serial.print(i);
+      Serial.print(F(" latency avg/max: "));
+      Serial.print(manager.getAverageLatency(i));
+      Serial.print(F("/"));
+      Serial.print(manager.getMaxLatency(i));
+      Serial.println(F(" ms"));
+    }
+  }
+}
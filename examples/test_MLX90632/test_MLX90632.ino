@@ -152,29 +152,32 @@ void setup() {
 }
 
 void loop() {
-  // Only check new data flag - much more efficient for continuous mode
-  if (mlx.isNewData()) {
+  // One status read gives new_data and the cycle position together
+  mlx90632_status_t status;
+  if (mlx.readStatus(&status) && status.new_data) {
     Serial.print(F("New Data Available - Cycle Position: "));
-    Serial.println(mlx.readCyclePosition());
+    Serial.println(status.cycle_position);
     
-    // Read ambient temperature
-    double ambientTemp = mlx.getAmbientTemperature();
+    // Read ambient and object temperature from the same RAM frame, using
+    // the cycle position from the status snapshot
+    double ambientTemp, objectTemp;
+    if (!mlx.readTemperatures(&ambientTemp, &objectTemp, &status)) {
+      Serial.println(F("Failed to read temperature frame"));
+    }
     Serial.print(F("Ambient Temperature: "));
     Serial.print(ambientTemp, 4);
     Serial.println(F(" °C"));
     
-    // Read object temperature
-    double objectTemp = mlx.getObjectTemperature();
     Serial.print(F("Object Temperature: "));
     if (isnan(objectTemp)) {
-      Serial.println(F("NaN (invalid cycle position)"));
+      Serial.println(F("NaN (unknown half-cycle)"));
     } else {
       Serial.print(objectTemp, 4);
       Serial.println(F(" °C"));
     }
     
-    // Reset new data flag after reading
-    if (!mlx.resetNewData()) {
+    // Reset new data flag after reading, from the same snapshot
+    if (!mlx.resetNewData(&status)) {
       Serial.println(F("Failed to reset new data flag"));
     }
     
@@ -0,0 +1,546 @@
+/*!
+ *  @file MLX90632_Simulator.cpp
+ *
+ *  Register-level MLX90632 simulator for the host build.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "MLX90632_Simulator.h"
+
+#define SIM_RAM_REF 18900 ///< Simulated RAM_9 / RAM_57 reference reading
+#define SIM_AMB_SCALE (524288.0 / 12.0) ///< 2^19 / 12, as in the driver
+
+/*!
+ *    @brief  Store a 32-bit calibration constant as two EEPROM words
+ *    @param  eeprom EEPROM contents
+ *    @param  lsw_addr Address of the least significant word
+ *    @param  value Value to store
+ */
+static void setEE32(uint16_t* eeprom, uint16_t lsw_addr, int32_t value) {
+  eeprom[lsw_addr - MLX90632_REG_MELEXIS_RESERVED0] = (uint32_t)value & 0xFFFF;
+  eeprom[lsw_addr - MLX90632_REG_MELEXIS_RESERVED0 + 1] =
+      (uint32_t)value >> 16;
+}
+
+/*!
+ *    @brief  Read a 32-bit calibration constant from two EEPROM words
+ *    @param  eeprom EEPROM contents
+ *    @param  lsw_addr Address of the least significant word
+ *    @return Signed value
+ */
+static int32_t getEE32(const uint16_t* eeprom, uint16_t lsw_addr) {
+  uint16_t index = lsw_addr - MLX90632_REG_MELEXIS_RESERVED0;
+
+  return (int32_t)(((uint32_t)eeprom[index + 1] << 16) | eeprom[index]);
+}
+
+/*!
+ *    @brief  Read a 16-bit calibration constant from EEPROM
+ *    @param  eeprom EEPROM contents
+ *    @param  addr Address of the word
+ *    @return Signed value
+ */
+static int16_t getEE16(const uint16_t* eeprom, uint16_t addr) {
+  return (int16_t)eeprom[addr - MLX90632_REG_MELEXIS_RESERVED0];
+}
+
+/*!
+ *    @brief  Round a simulated reading to a RAM word
+ *    @param  value Reading
+ *    @return Nearest 16-bit signed value, saturated
+ */
+static int16_t toRaw(double value) {
+  if (value > 32767.0) {
+    return 32767;
+  }
+  if (value < -32768.0) {
+    return -32768;
+  }
+  return (int16_t)lround(value);
+}
+
+/*!
+ *    @brief  Instantiates a simulated MLX90632 with datasheet example
+ *            calibration, 2 Hz refresh rate and continuous medical mode
+ */
+MLX90632_Simulator::MLX90632_Simulator() {
+  memset(eeprom, 0, sizeof(eeprom));
+  memset(ram, 0, sizeof(ram));
+
+#define EE(reg) eeprom[(reg) - MLX90632_REG_MELEXIS_RESERVED0]
+  EE(MLX90632_REG_ID0) = 0x1234;
+  EE(MLX90632_REG_ID1) = 0x5678;
+  EE(MLX90632_REG_ID2) = 0x9ABC;
+  EE(MLX90632_REG_EE_PRODUCT_CODE) = 0x0021; // 50 degree FOV, SFN, medical
+  EE(MLX90632_REG_EE_VERSION) = 0x0105;
+
+  setEE32(eeprom, MLX90632_REG_EE_P_R_LSW, 0x00587f5b);
+  setEE32(eeprom, MLX90632_REG_EE_P_G_LSW, 0x04a10289);
+  setEE32(eeprom, MLX90632_REG_EE_P_T_LSW, (int32_t)0xfff966f8);
+  setEE32(eeprom, MLX90632_REG_EE_P_O_LSW, 0x00001e0f);
+  setEE32(eeprom, MLX90632_REG_EE_EA_LSW, 4859535);
+  setEE32(eeprom, MLX90632_REG_EE_EB_LSW, 5686508);
+  setEE32(eeprom, MLX90632_REG_EE_FA_LSW, 53855361);
+  setEE32(eeprom, MLX90632_REG_EE_FB_LSW, 42874149);
+  setEE32(eeprom, MLX90632_REG_EE_GA_LSW, -14556410);
+  EE(MLX90632_REG_EE_GB) = 9728;
+  EE(MLX90632_REG_EE_KA) = 10752;
+  EE(MLX90632_REG_EE_KB) = 0;
+  EE(MLX90632_REG_EE_HA) = 16384;
+  EE(MLX90632_REG_EE_HB) = 0;
+
+  EE(MLX90632_REG_EE_CONTROL) = MLX90632_MODE_CONTINUOUS << 1;
+  EE(MLX90632_REG_EE_I2C_ADDRESS) = MLX90632_DEFAULT_ADDR >> 1;
+  EE(MLX90632_REG_EE_MEAS_1) = 0x820D;
+  EE(MLX90632_REG_EE_MEAS_2) = 0x821D;
+#undef EE
+
+  ambient_c = 25.0;
+  object_c = 36.6;
+  noise_lsb = 0;
+  noise_seed = 1;
+  measurements = 0;
+  ee_unlocked = false;
+  ee_busy_end_ns = 0;
+  ee_cycles = 0;
+  ee_stuck = false;
+  failed_reads = 0;
+  powerOnReset();
+}
+
+/*!
+ *    @brief  Connect the simulator to a host bus
+ *    @param  i2c_addr Address to answer to, also stored in EE_I2C_ADDRESS
+ *    @param  wire Host bus
+ *    @return True if attached
+ */
+bool MLX90632_Simulator::begin(uint8_t i2c_addr, TwoWire* wire) {
+  eeprom[MLX90632_REG_EE_I2C_ADDRESS - MLX90632_REG_MELEXIS_RESERVED0] =
+      i2c_addr >> 1;
+  powerOnReset();
+  return wire->attach(i2c_addr, this);
+}
+
+/*!
+ *    @brief  Set the temperature of the sensor die, used from the next
+ *            completed measurement on
+ *    @param  celsius Ambient temperature in degrees Celsius
+ */
+void MLX90632_Simulator::setAmbientTemperature(double celsius) {
+  update();
+  ambient_c = celsius;
+}
+
+/*!
+ *    @brief  Set the temperature of the object in view, used from the next
+ *            completed measurement on
+ *    @param  celsius Object temperature in degrees Celsius
+ */
+void MLX90632_Simulator::setObjectTemperature(double celsius) {
+  update();
+  object_c = celsius;
+}
+
+/*!
+ *    @brief  Add uniform noise to the object RAM words
+ *    @param  lsb Peak noise in RAM word LSBs, 0 for none
+ */
+void MLX90632_Simulator::setNoise(uint16_t lsb) {
+  noise_lsb = lsb;
+}
+
+/*!
+ *    @brief  Keep eeprom_busy set after the next erase or write cycle, as a
+ *            failing EEPROM would
+ *    @param  stuck True to never end EEPROM cycles
+ */
+void MLX90632_Simulator::setEEPROMStuck(bool stuck) {
+  update();
+  ee_stuck = stuck;
+}
+
+/*!
+ *    @brief  NACK the next read transfers, as a glitching bus would
+ *    @param  count Number of read transfers to fail
+ */
+void MLX90632_Simulator::failReads(uint8_t count) {
+  failed_reads = count;
+}
+
+/*!
+ *    @brief  Read a word without going through the bus
+ *    @param  addr Register address
+ *    @return Register contents
+ */
+uint16_t MLX90632_Simulator::peek(uint16_t addr) {
+  update();
+  return readWord(addr);
+}
+
+/*!
+ *    @brief  Overwrite a word without going through the bus and without
+ *            side effects, e.g. to load other calibration into the EEPROM
+ *    @param  addr Register address
+ *    @param  value Value to store
+ */
+void MLX90632_Simulator::poke(uint16_t addr, uint16_t value) {
+  update();
+  if (addr >= MLX90632_REG_MELEXIS_RESERVED0 &&
+      addr < MLX90632_REG_MELEXIS_RESERVED0 + MLX90632_SIM_EEPROM_WORDS) {
+    eeprom[addr - MLX90632_REG_MELEXIS_RESERVED0] = value;
+  } else if (addr >= MLX90632_REG_RAM_1 &&
+             addr < MLX90632_REG_RAM_1 + MLX90632_SIM_RAM_WORDS) {
+    ram[addr - MLX90632_REG_RAM_1] = value;
+  } else if (addr == MLX90632_REG_CONTROL) {
+    control = value;
+  } else if (addr == MLX90632_REG_STATUS) {
+    status = value;
+  }
+}
+
+/*!
+ *    @brief  Get the number of completed measurements
+ *    @return Measurements since construction
+ */
+uint32_t MLX90632_Simulator::getMeasurementCount() {
+  update();
+  return measurements;
+}
+
+/*!
+ *    @brief  Get the number of EEPROM erase and write cycles, to check that
+ *            the driver only wears the EEPROM when it has to
+ *    @return Cycles since construction
+ */
+uint32_t MLX90632_Simulator::getEEPROMCycles() {
+  return ee_cycles;
+}
+
+/*!
+ *    @brief  Reload CONTROL from EEPROM and restart, as after power-up or an
+ *            addressed reset
+ */
+void MLX90632_Simulator::powerOnReset() {
+  control = eeprom[MLX90632_REG_EE_CONTROL - MLX90632_REG_MELEXIS_RESERVED0];
+  status = 0;
+  pointer = 0;
+  measuring = false;
+  meas_end_ns = 0;
+  table_entry = 0;
+  burst_entries = 0;
+
+  if (((control >> 1) & 0x3) == MLX90632_MODE_CONTINUOUS) {
+    startMeasurement(hostNanos());
+  }
+}
+
+/*!
+ *    @brief  Complete every measurement that has ended by now
+ */
+void MLX90632_Simulator::update() {
+  uint64_t now = hostNanos();
+
+  while (measuring && meas_end_ns <= now) {
+    completeMeasurement();
+  }
+  if ((status & (1 << 9)) && !ee_stuck && ee_busy_end_ns <= now) {
+    status &= ~(1 << 9); // eeprom_busy
+  }
+}
+
+/*!
+ *    @brief  Number of entries in the measurement table of the selected
+ *            measurement type
+ *    @return 2 for medical, 3 for extended range
+ */
+uint8_t MLX90632_Simulator::tableLength() {
+  uint8_t meas_select = (control >> 4) & 0x1F;
+
+  return (meas_select == MLX90632_MEAS_EXTENDED_RANGE) ? 3 : 2;
+}
+
+/*!
+ *    @brief  Duration of one table entry from its EE_MEAS refresh rate
+ *    @param  entry Table entry
+ *    @return Duration in nanoseconds
+ */
+uint64_t MLX90632_Simulator::measurementTime(uint8_t entry) {
+  uint16_t meas = eeprom[(entry == 0 ? MLX90632_REG_EE_MEAS_1
+                                     : MLX90632_REG_EE_MEAS_2) -
+                         MLX90632_REG_MELEXIS_RESERVED0];
+
+  // 0.5 Hz (2 s) halves with each refresh rate step, as in the driver
+  return 2000000000ULL >> ((meas >> 8) & 0x7);
+}
+
+/*!
+ *    @brief  Start measuring the current table entry
+ *    @param  start_ns Virtual time the measurement starts
+ */
+void MLX90632_Simulator::startMeasurement(uint64_t start_ns) {
+  measuring = true;
+  meas_end_ns = start_ns + measurementTime(table_entry);
+  status |= (1 << 10); // device_busy
+}
+
+/*!
+ *    @brief  Publish the running measurement and start the next one if the
+ *            mode asks for it
+ */
+void MLX90632_Simulator::completeMeasurement() {
+  uint8_t cycle_position = table_entry + 1;
+
+  measurements++;
+  writeFrame(cycle_position);
+
+  // new_data is bit 0, cycle_position is bits 6:2
+  status = (status & ~(0x1F << 2)) | (cycle_position << 2) | 0x0001;
+  table_entry = cycle_position % tableLength();
+
+  if (burst_entries > 0) {
+    burst_entries--;
+  }
+  if (((control >> 1) & 0x3) == MLX90632_MODE_CONTINUOUS ||
+      burst_entries > 0) {
+    startMeasurement(meas_end_ns);
+  } else {
+    measuring = false;
+    status &= ~(1 << 10);
+  }
+}
+
+/*!
+ *    @brief  Next sample of the noise generator
+ *    @return Value in -noise_lsb..noise_lsb
+ */
+int16_t MLX90632_Simulator::noise() {
+  if (noise_lsb == 0) {
+    return 0;
+  }
+  noise_seed = noise_seed * 1664525UL + 1013904223UL;
+  return (int16_t)((noise_seed >> 16) % (2 * noise_lsb + 1)) - noise_lsb;
+}
+
+/*!
+ *    @brief  Fill the RAM words of a finished measurement from the simulated
+ *            temperatures, inverting the datasheet equations at the
+ *            steady state of the driver's single-pass solver
+ *    @param  cycle_position Cycle position the measurement finishes
+ */
+void MLX90632_Simulator::writeFrame(uint8_t cycle_position) {
+  double P_R = getEE32(eeprom, MLX90632_REG_EE_P_R_LSW) * ldexp(1, -8);
+  double P_G = getEE32(eeprom, MLX90632_REG_EE_P_G_LSW) * ldexp(1, -20);
+  double P_T = getEE32(eeprom, MLX90632_REG_EE_P_T_LSW) * ldexp(1, -44);
+  double P_O = getEE32(eeprom, MLX90632_REG_EE_P_O_LSW) * ldexp(1, -8);
+  double Ea = getEE32(eeprom, MLX90632_REG_EE_EA_LSW) * ldexp(1, -16);
+  double Eb = getEE32(eeprom, MLX90632_REG_EE_EB_LSW) * ldexp(1, -8);
+  double Fa = getEE32(eeprom, MLX90632_REG_EE_FA_LSW) * ldexp(1, -46);
+  double Ga = getEE32(eeprom, MLX90632_REG_EE_GA_LSW) * ldexp(1, -36);
+  double Gb = getEE16(eeprom, MLX90632_REG_EE_GB) * ldexp(1, -10);
+  double Ka = getEE16(eeprom, MLX90632_REG_EE_KA) * ldexp(1, -10);
+  double Ha = getEE16(eeprom, MLX90632_REG_EE_HA) * ldexp(1, -14);
+  double Hb = getEE16(eeprom, MLX90632_REG_EE_HB) * ldexp(1, -10);
+  double ref = SIM_RAM_REF;
+
+  // Ambient: solve P_T * d^2 + d / P_G + P_O - TA = 0 for d = AMB - P_R
+  double b = 1.0 / P_G;
+  double c = P_O - ambient_c;
+  double d = -2.0 * c / (b + sqrt(b * b - 4.0 * P_T * c));
+  double AMB = P_R + d;
+
+  // AMB = amb * 2^19 / 12 / (ref + Gb * amb / 12), solved for amb
+  int16_t amb = toRaw(AMB * ref / (SIM_AMB_SCALE - AMB * Gb / 12.0));
+  AMB = amb * SIM_AMB_SCALE / (ref + Gb / 12.0 * amb);
+  double TADUT = (AMB - Eb) / Ea + 25.0;
+
+  // Object: with TODUT = TADUT, TO0 = TO and TA0 = TADUT the solver's
+  // denominator is 1 + Ga * (TADUT - TO)
+  double TAK4 = pow(TADUT + 273.15, 4);
+  double TOK4 = pow(object_c + 273.15 + Hb, 4);
+  double denominator = 1.0 + Ga * (TADUT - object_c);
+  double STO = (TOK4 - TAK4) * denominator * MLX90632_EMISSIVITY * Fa * Ha;
+  double S = STO * (ref + Ka / 12.0 * amb) / SIM_AMB_SCALE;
+
+  if (tableLength() == 3) {
+    // Extended range: S = (RAM_52 - RAM_53 - RAM_55 + RAM_56) / 2 +
+    // RAM_58 + RAM_59
+    uint16_t* frame = &ram[MLX90632_REG_RAM_52 - MLX90632_REG_RAM_1];
+    int16_t half = toRaw(S / 2);
+
+    frame[0] = frame[1] = frame[3] = frame[4] = 0;
+    frame[2] = amb;
+    frame[5] = SIM_RAM_REF;
+    frame[6] = half + noise();
+    frame[7] = toRaw(S - half) + noise();
+    return;
+  }
+
+  // Medical: S is the mean of RAM_4/5 at cycle position 2 and of RAM_7/8 at
+  // cycle position 1; RAM_6 and RAM_9 are shared
+  uint16_t* frame = &ram[MLX90632_REG_RAM_4 - MLX90632_REG_RAM_1];
+  uint8_t first = (cycle_position == 2) ? 0 : 3;
+  int16_t lower = toRaw(S);
+
+  frame[first] = lower + noise();
+  frame[first + 1] = toRaw(2 * S - lower) + noise();
+  frame[2] = amb;
+  frame[5] = SIM_RAM_REF;
+}
+
+/*!
+ *    @brief  Read a register as the bus sees it
+ *    @param  addr Register address
+ *    @return Register contents, 0 for unmapped addresses
+ */
+uint16_t MLX90632_Simulator::readWord(uint16_t addr) {
+  if (addr >= MLX90632_REG_MELEXIS_RESERVED0 &&
+      addr < MLX90632_REG_MELEXIS_RESERVED0 + MLX90632_SIM_EEPROM_WORDS) {
+    return eeprom[addr - MLX90632_REG_MELEXIS_RESERVED0];
+  }
+  if (addr >= MLX90632_REG_RAM_1 &&
+      addr < MLX90632_REG_RAM_1 + MLX90632_SIM_RAM_WORDS) {
+    return ram[addr - MLX90632_REG_RAM_1];
+  }
+  switch (addr) {
+    case MLX90632_REG_I2C_ADDRESS:
+      return eeprom[MLX90632_REG_EE_I2C_ADDRESS -
+                    MLX90632_REG_MELEXIS_RESERVED0];
+    case MLX90632_REG_CONTROL:
+      return control;
+    case MLX90632_REG_STATUS:
+      return status;
+    default:
+      return 0;
+  }
+}
+
+/*!
+ *    @brief  Write a register as the bus sees it
+ *    @param  addr Register address
+ *    @param  value Value written
+ */
+void MLX90632_Simulator::writeWord(uint16_t addr, uint16_t value) {
+  if (addr >= MLX90632_REG_MELEXIS_RESERVED0 &&
+      addr < MLX90632_REG_MELEXIS_RESERVED0 + MLX90632_SIM_EEPROM_WORDS) {
+    uint16_t* word = &eeprom[addr - MLX90632_REG_MELEXIS_RESERVED0];
+
+    // Each erase or write needs its own unlock and an idle EEPROM
+    if (!ee_unlocked || (status & (1 << 9))) {
+      return;
+    }
+    ee_unlocked = false;
+
+    // Writing 0 erases the word. Programming can only set bits, so a word
+    // that wasn't erased first ends up as the OR of old and new value.
+    *word = (value == 0) ? 0 : (*word | value);
+    ee_cycles++;
+    ee_busy_end_ns = hostNanos() + MLX90632_SIM_EE_CYCLE_NS;
+    status |= (1 << 9);
+    return;
+  }
+
+  switch (addr) {
+    case MLX90632_REG_CONTROL: {
+      uint8_t old_select = (control >> 4) & 0x1F;
+      uint8_t mode;
+
+      // SOC (bit 3) and SOB (bit 11) self-clear
+      control = value & ~((1 << 3) | (1 << 11));
+      mode = (control >> 1) & 0x3;
+      if (((control >> 4) & 0x1F) != old_select) {
+        table_entry = 0;
+      }
+
+      if (mode == MLX90632_MODE_HALT) {
+        measuring = false;
+        burst_entries = 0;
+        status &= ~(1 << 10);
+      } else if (mode == MLX90632_MODE_CONTINUOUS) {
+        if (!measuring) {
+          startMeasurement(hostNanos());
+        }
+      } else if (!measuring && (value & ((1 << 3) | (1 << 11)))) {
+        // Step modes: SOC measures one table entry, SOB the whole table
+        burst_entries = (value & (1 << 11)) ? tableLength() : 1;
+        startMeasurement(hostNanos());
+      } else if (burst_entries == 0) {
+        // Switched from continuous to a step mode: finish this entry only
+        burst_entries = measuring ? 1 : 0;
+      }
+      break;
+    }
+    case MLX90632_REG_STATUS:
+      // Only new_data can be written (cleared)
+      status = (status & ~0x0001) | (value & 0x0001);
+      break;
+    case MLX90632_REG_I2C_COMMAND:
+      if (value == MLX90632_CMD_RESET) {
+        powerOnReset();
+      }
+      ee_unlocked = (value == MLX90632_CMD_EE_UNLOCK);
+      break;
+    default:
+      // CONTROL, STATUS and the command register are the only writable
+      // registers outside EEPROM
+      break;
+  }
+}
+
+/*!
+ *    @brief  Handle a write transfer: a 2-byte address phase before a read, or
+ *            a single register write
+ *    @param  data Address and value, big-endian
+ *    @param  len 2 or 4 bytes, 0 for an address probe
+ *    @param  stop Ignored, the address is kept either way
+ *    @return True to ACK
+ */
+bool MLX90632_Simulator::i2cWrite(const uint8_t* data, size_t len,
+                                  bool stop) {
+  (void)stop;
+  update();
+
+  if (len == 0) {
+    // Address probe
+    return true;
+  }
+  if (len < 2) {
+    return false;
+  }
+  pointer = ((uint16_t)data[0] << 8) | data[1];
+  if (len == 2) {
+    // Address phase of a read
+    return true;
+  }
+  if (len != 4) {
+    // The device only takes single word writes
+    return false;
+  }
+  writeWord(pointer, ((uint16_t)data[2] << 8) | data[3]);
+  return true;
+}
+
+/*!
+ *    @brief  Handle a read transfer from the address of the last write
+ *    @param  data Buffer to fill with big-endian words
+ *    @param  len Number of bytes
+ *    @return False while failReads() has reads left to fail
+ */
+bool MLX90632_Simulator::i2cRead(uint8_t* data, size_t len) {
+  update();
+  if (failed_reads) {
+    failed_reads--;
+    return false;
+  }
+
+  // Big-endian words, the address auto-increments
+  for (size_t i = 0; i < len; i += 2) {
+    uint16_t value = readWord(pointer++);
+
+    data[i] = value >> 8;
+    if (i + 1 < len) {
+      data[i + 1] = value & 0xFF;
+    }
+  }
+  return true;
+}
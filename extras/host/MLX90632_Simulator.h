@@ -0,0 +1,87 @@
+/*!
+ *  @file MLX90632_Simulator.h
+ *
+ *  Register-level MLX90632 simulator for the host build.
+ *
+ *  Models the EEPROM calibration block, the RAM words of medical and
+ *  extended range frames, the CONTROL register (mode, SOC, SOB), the STATUS
+ *  new_data / cycle_position / eeprom_busy / device_busy bits, the addressed
+ *  reset, the EEPROM unlock / erase / write cycle and the measurement timing
+ *  from the EE_MEAS refresh rates. RAM values are generated from the
+ *  configured ambient and object temperatures by running the datasheet
+ *  equations backwards, so a driver reading the simulator should get those
+ *  temperatures back.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#ifndef _MLX90632_SIMULATOR_H
+#define _MLX90632_SIMULATOR_H
+
+#include "Adafruit_MLX90632.h"
+#include "Wire.h"
+
+#define MLX90632_SIM_EEPROM_WORDS 0x100 ///< 0x2400..0x24FF
+#define MLX90632_SIM_RAM_WORDS 0x100    ///< 0x4000..0x40FF
+#define MLX90632_SIM_EE_CYCLE_NS \
+  8000000ULL ///< Duration of one EEPROM erase or write
+
+/*!
+ *    @brief  Simulated MLX90632 on a host TwoWire bus
+ */
+class MLX90632_Simulator : public HostI2CTarget {
+ public:
+  MLX90632_Simulator();
+  bool begin(uint8_t i2c_addr = MLX90632_DEFAULT_ADDR, TwoWire* wire = &Wire);
+
+  void setAmbientTemperature(double celsius);
+  void setObjectTemperature(double celsius);
+  void setNoise(uint16_t lsb);
+  void setEEPROMStuck(bool stuck);
+  void failReads(uint8_t count);
+
+  uint16_t peek(uint16_t addr);
+  void poke(uint16_t addr, uint16_t value);
+  uint32_t getMeasurementCount();
+  uint32_t getEEPROMCycles();
+
+  bool i2cWrite(const uint8_t* data, size_t len, bool stop) override;
+  bool i2cRead(uint8_t* data, size_t len) override;
+
+ private:
+  void powerOnReset();
+  void update();
+  void startMeasurement(uint64_t start_ns);
+  void completeMeasurement();
+  uint8_t tableLength();
+  uint64_t measurementTime(uint8_t entry);
+  void writeFrame(uint8_t cycle_position);
+  int16_t noise();
+  uint16_t readWord(uint16_t addr);
+  void writeWord(uint16_t addr, uint16_t value);
+
+  uint16_t eeprom[MLX90632_SIM_EEPROM_WORDS]; ///< EEPROM contents
+  uint16_t ram[MLX90632_SIM_RAM_WORDS];       ///< RAM contents
+  uint16_t control;                           ///< CONTROL register
+  uint16_t status;                            ///< STATUS register
+  uint16_t pointer;                           ///< Address of the next read
+
+  bool measuring;        ///< A measurement is running
+  uint64_t meas_end_ns;  ///< Virtual time the running measurement ends
+  uint8_t table_entry;   ///< Entry of the measurement table being measured
+  uint8_t burst_entries; ///< Entries left to measure after an SOC/SOB
+  uint32_t measurements; ///< Completed measurements
+
+  bool ee_unlocked;        ///< The next EEPROM write is accepted
+  uint64_t ee_busy_end_ns; ///< Virtual time the EEPROM cycle ends
+  uint32_t ee_cycles;      ///< Completed EEPROM erase and write cycles
+  bool ee_stuck;           ///< eeprom_busy never clears
+  uint8_t failed_reads;    ///< Read transfers left to NACK
+
+  double ambient_c;    ///< Simulated ambient temperature
+  double object_c;     ///< Simulated object temperature
+  uint16_t noise_lsb;  ///< Peak noise added to the object RAM words
+  uint32_t noise_seed; ///< State of the noise generator
+};
+
+#endif
@@ -0,0 +1,481 @@
+/*!
+ *  @file benchmark.cpp
+ *
+ *  Cost of the MLX90632 API calls on the host build, as JSON lines on
+ *  stdout.
+ *
+ *  Usage: mlx90632_benchmark [--baseline <file>]
+ *
+ *  Bus records ("kind":"bus") are measured against the simulator at 100 kHz,
+ *  400 kHz and 1 MHz: driver register transactions, I2C transfers (address
+ *  phases), bytes on the wire and time on the wire. They are deterministic,
+ *  so with --baseline the run fails (exit status 1) if any of them grew
+ *  compared to an earlier run's output.
+ *
+ *  CPU records ("kind":"cpu") time the bus-free math on the host in
+ *  nanoseconds per frame. They depend on the machine and are reported only.
+ *
+ *  Log records ("kind":"log") encode captured frames in the frame log
+ *  format and report the bytes per frame, the compression ratio against
+ *  the raw words plus a 32-bit time, and the decode time per frame. A log
+ *  that doesn't decode back to the captured frames fails the run.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include <chrono>
+
+#include "Adafruit_MLX90632_Log.h"
+#include "MLX90632_Simulator.h"
+
+#define POLL_SAMPLES 16       ///< Samples averaged for the poll() record
+#define CPU_FRAMES 1024       ///< Frames per CPU timing pass
+#define CPU_REPEATS 200       ///< Timing passes, the fastest one is reported
+#define MAX_BASELINE 64       ///< Bus records read from a baseline file
+#define LOG_STORE (64 * 1024) ///< Encoded log of one log record
+
+/*!
+ *    @brief  One bus record
+ */
+typedef struct {
+  char op[32];         ///< API call
+  uint32_t clock_hz;   ///< SCL frequency
+  double transactions; ///< Driver register transactions per call
+  double transfers;    ///< I2C address phases per call
+  double bytes;        ///< Data bytes on the wire per call
+  double bus_us;       ///< Time on the wire per call
+} bus_record_t;
+
+static const uint32_t clocks[] = {100000, 400000, 1000000}; ///< SCL rates
+
+static bus_record_t baseline[MAX_BASELINE]; ///< Records of an earlier run
+static size_t baseline_count = 0;           ///< Records in baseline
+static bool regressed = false;              ///< A record got worse or failed
+
+/*!
+ *    @brief  Print a bus record and compare it with the baseline
+ *    @param  r Record
+ */
+static void report(const bus_record_t& r) {
+  printf("{\"kind\":\"bus\",\"op\":\"%s\",\"clock_hz\":%u,"
+         "\"transactions\":%.2f,\"transfers\":%.2f,\"bytes\":%.2f,"
+         "\"bus_us\":%.2f}\n",
+         r.op, (unsigned)r.clock_hz, r.transactions, r.transfers, r.bytes,
+         r.bus_us);
+
+  for (size_t i = 0; i < baseline_count; i++) {
+    const bus_record_t& b = baseline[i];
+
+    if (strcmp(b.op, r.op) != 0 || b.clock_hz != r.clock_hz) {
+      continue;
+    }
+    // Allow for the rounding of the printed values
+    if (r.transactions > b.transactions + 0.005 ||
+        r.transfers > b.transfers + 0.005 || r.bytes > b.bytes + 0.005 ||
+        r.bus_us > b.bus_us + 0.005) {
+      fprintf(stderr, "Regression in %s at %u Hz\n", r.op,
+              (unsigned)r.clock_hz);
+      regressed = true;
+    }
+  }
+}
+
+/*!
+ *    @brief  Read the bus records of an earlier run
+ *    @param  path File with the earlier output
+ *    @return True if the file could be read
+ */
+static bool loadBaseline(const char* path) {
+  FILE* file = fopen(path, "r");
+  char line[256];
+
+  if (!file) {
+    return false;
+  }
+  while (baseline_count < MAX_BASELINE && fgets(line, sizeof(line), file)) {
+    bus_record_t& b = baseline[baseline_count];
+    unsigned clock_hz;
+
+    if (sscanf(line,
+               "{\"kind\":\"bus\",\"op\":\"%31[^\"]\",\"clock_hz\":%u,"
+               "\"transactions\":%lf,\"transfers\":%lf,\"bytes\":%lf,"
+               "\"bus_us\":%lf}",
+               b.op, &clock_hz, &b.transactions, &b.transfers, &b.bytes,
+               &b.bus_us) == 6) {
+      b.clock_hz = clock_hz;
+      baseline_count++;
+    }
+  }
+  fclose(file);
+  return true;
+}
+
+/*!
+ *    @brief  Measure the bus traffic of an operation at every clock
+ *    @param  op Name of the operation
+ *    @param  calls Number of API calls the operation makes
+ *    @param  setup Prepares the operation, not measured
+ *    @param  run The operation
+ */
+static void measureBus(const char* op, uint32_t calls,
+                       bool (*setup)(Adafruit_MLX90632&),
+                       bool (*run)(Adafruit_MLX90632&)) {
+  for (size_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); c++) {
+    MLX90632_Simulator sensor;
+    Adafruit_MLX90632 mlx;
+    bus_record_t r;
+
+    Wire.setClock(clocks[c]);
+    sensor.begin();
+    if ((setup && !setup(mlx)) || !mlx.begin()) {
+      fprintf(stderr, "%s: setup failed\n", op);
+      regressed = true;
+      return;
+    }
+    // Let the first full measurement table complete
+    delay(2 * mlx.getRefreshPeriod() + 1);
+
+    mlx.resetTransactionCount();
+    Wire.resetStats();
+    if (!run(mlx)) {
+      fprintf(stderr, "%s: failed\n", op);
+      regressed = true;
+    }
+
+    const host_i2c_stats_t& stats = Wire.getStats();
+    snprintf(r.op, sizeof(r.op), "%s", op);
+    r.clock_hz = clocks[c];
+    r.transactions = (double)mlx.getTransactionCount() / calls;
+    r.transfers = (double)stats.transfers / calls;
+    r.bytes = (double)(stats.bytes_written + stats.bytes_read) / calls;
+    r.bus_us = stats.bus_time_ns / 1000.0 / calls;
+    report(r);
+  }
+}
+
+/*!
+ *    @brief  begin() again on a begun driver
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runBegin(Adafruit_MLX90632& mlx) {
+  return mlx.begin();
+}
+
+static mlx90632_cal_blob_t blob; ///< Calibration for the warm begin()
+
+/*!
+ *    @brief  Export the calibration for the warm begin() record
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool setupBeginWarm(Adafruit_MLX90632& mlx) {
+  return mlx.begin() && mlx.exportCalibration(&blob);
+}
+
+/*!
+ *    @brief  begin() with a stored calibration
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runBeginWarm(Adafruit_MLX90632& mlx) {
+  return mlx.begin(blob) && mlx.isWarmStarted();
+}
+
+/*!
+ *    @brief  Reload the calibration
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runGetCalibrations(Adafruit_MLX90632& mlx) {
+  return mlx.getCalibrations();
+}
+
+/*!
+ *    @brief  Blocking ambient temperature read
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runGetAmbient(Adafruit_MLX90632& mlx) {
+  return !isnan(mlx.getAmbientTemperature());
+}
+
+/*!
+ *    @brief  Blocking object temperature read
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runGetObject(Adafruit_MLX90632& mlx) {
+  return !isnan(mlx.getObjectTemperature());
+}
+
+/*!
+ *    @brief  Blocking read of both temperatures from one frame
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runReadTemperatures(Adafruit_MLX90632& mlx) {
+  double ambient, object;
+
+  return mlx.readTemperatures(&ambient, &object);
+}
+
+/*!
+ *    @brief  Read and decode the STATUS register
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runReadStatus(Adafruit_MLX90632& mlx) {
+  mlx90632_status_t status;
+
+  return mlx.readStatus(&status);
+}
+
+/*!
+ *    @brief  readFrameAsync() callback
+ *    @param  context Where to store the result
+ *    @param  result How the chain ended
+ *    @param  sample The sample
+ */
+static void asyncDone(void* context, mlx90632_async_result_t result,
+                      const mlx90632_sample_t* sample) {
+  (void)sample;
+  *static_cast<int*>(context) = result;
+}
+
+/*!
+ *    @brief  One asynchronous frame read, which runs to the end on Wire
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runReadFrameAsync(Adafruit_MLX90632& mlx) {
+  int result = -1;
+
+  return mlx.readFrameAsync(asyncDone, &result) &&
+         result == MLX90632_ASYNC_DONE;
+}
+
+/*!
+ *    @brief  Run poll() until POLL_SAMPLES samples completed
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool runPoll(Adafruit_MLX90632& mlx) {
+  for (uint8_t i = 0; i < POLL_SAMPLES; i++) {
+    while (mlx.poll() != MLX90632_STATE_READY) {
+      delay(1);
+    }
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Continuous medical mode at 8 Hz for the poll() record
+ *    @param  mlx Driver
+ *    @return True on success
+ */
+static bool setupPoll(Adafruit_MLX90632& mlx) {
+  return mlx.begin() && mlx.setMode(MLX90632_MODE_CONTINUOUS) &&
+         mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL) &&
+         mlx.setRefreshRate(MLX90632_REFRESH_8HZ);
+}
+
+/*!
+ *    @brief  Print a CPU record
+ *    @param  op Name of the operation
+ *    @param  ns Nanoseconds per frame
+ */
+static void reportCPU(const char* op, double ns) {
+  printf("{\"kind\":\"cpu\",\"op\":\"%s\",\"ns_per_frame\":%.2f}\n", op, ns);
+}
+
+/*!
+ *    @brief  Time the bus-free conversion functions on captured frames
+ */
+static void measureCPU() {
+  static mlx90632_frame_t frames[CPU_FRAMES];
+  static mlx90632_real_t ambient[CPU_FRAMES];
+  static mlx90632_real_t object[CPU_FRAMES];
+  volatile mlx90632_real_t sink = 0;
+  MLX90632_Simulator sensor;
+  Adafruit_MLX90632 mlx;
+  mlx90632_solver_t solver;
+  double best[3] = {1e30, 1e30, 1e30};
+
+  sensor.begin();
+  if (!mlx.begin() || !mlx.setRefreshRate(MLX90632_REFRESH_64HZ)) {
+    fprintf(stderr, "cpu: setup failed\n");
+    regressed = true;
+    return;
+  }
+  sensor.setNoise(20);
+  for (size_t i = 0; i < CPU_FRAMES; i++) {
+    while (mlx.poll() != MLX90632_STATE_READY) {
+      delay(1);
+    }
+    frames[i] = mlx.getLastFrame();
+  }
+
+  const mlx90632_calibration_t& cal = mlx.getCalibration();
+  Adafruit_MLX90632::initSolver(&solver);
+
+  for (int r = 0; r < CPU_REPEATS; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < CPU_FRAMES; i++) {
+      ambient[i] = Adafruit_MLX90632::computeAmbient(frames[i], cal);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < CPU_FRAMES; i++) {
+      object[i] = Adafruit_MLX90632::computeObject(frames[i], cal, &solver);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    Adafruit_MLX90632::computeBatch(frames, CPU_FRAMES, cal, &solver, ambient,
+                                    object);
+    auto t3 = std::chrono::steady_clock::now();
+    sink = sink + ambient[CPU_FRAMES - 1] + object[CPU_FRAMES - 1];
+
+    best[0] = fmin(best[0], std::chrono::duration<double>(t1 - t0).count());
+    best[1] = fmin(best[1], std::chrono::duration<double>(t2 - t1).count());
+    best[2] = fmin(best[2], std::chrono::duration<double>(t3 - t2).count());
+  }
+
+  reportCPU("computeAmbient", best[0] * 1e9 / CPU_FRAMES);
+  reportCPU("computeObject", best[1] * 1e9 / CPU_FRAMES);
+  reportCPU("computeBatch", best[2] * 1e9 / CPU_FRAMES);
+}
+
+static uint8_t log_store[LOG_STORE]; ///< Encoded log
+static size_t log_length = 0;        ///< Bytes in log_store
+
+/*!
+ *    @brief  Log encoder write callback, appends to log_store
+ *    @param  context Unused
+ *    @param  data Bytes to store
+ *    @param  len Number of bytes
+ *    @return False if the store is full
+ */
+static bool storeLog(void* context, const uint8_t* data, size_t len) {
+  (void)context;
+  if (log_length + len > sizeof(log_store)) {
+    return false;
+  }
+  memcpy(log_store + log_length, data, len);
+  log_length += len;
+  return true;
+}
+
+/*!
+ *    @brief  Encode frames captured at one noise level and measurement
+ *            type, check that they decode back unchanged and time decoding
+ *    @param  op Name of the record
+ *    @param  meas_select Measurement type
+ *    @param  noise Simulator noise in RAM word LSBs
+ */
+static void measureLog(const char* op, mlx90632_meas_select_t meas_select,
+                       uint16_t noise) {
+  static mlx90632_frame_t frames[CPU_FRAMES];
+  static uint32_t times[CPU_FRAMES];
+  static mlx90632_frame_t decoded[CPU_FRAMES];
+  static uint32_t decoded_times[CPU_FRAMES];
+  uint8_t words = meas_select == MLX90632_MEAS_MEDICAL ? 6 : 8;
+  MLX90632_Simulator sensor;
+  Adafruit_MLX90632 mlx;
+  Adafruit_MLX90632_LogEncoder encoder;
+  Adafruit_MLX90632_LogDecoder decoder;
+  mlx90632_cal_blob_t cal_blob;
+  double best = 1e30;
+
+  sensor.begin();
+  sensor.setNoise(noise);
+  log_length = 0;
+  if (!mlx.begin() || !mlx.setRefreshRate(MLX90632_REFRESH_64HZ) ||
+      !mlx.setMeasurementSelect(meas_select) ||
+      !mlx.exportCalibration(&cal_blob) ||
+      !encoder.begin(cal_blob, meas_select, storeLog)) {
+    fprintf(stderr, "log %s: setup failed\n", op);
+    regressed = true;
+    return;
+  }
+  for (size_t i = 0; i < CPU_FRAMES; i++) {
+    sensor.setObjectTemperature(30.0 + 0.01 * i);
+    while (mlx.poll() != MLX90632_STATE_READY) {
+      delay(1);
+    }
+    frames[i] = mlx.getLastFrame();
+    times[i] = millis();
+    if (!encoder.add(frames[i], times[i])) {
+      fprintf(stderr, "log %s: add() failed\n", op);
+      regressed = true;
+      return;
+    }
+  }
+  if (!encoder.flush()) {
+    fprintf(stderr, "log %s: flush() failed\n", op);
+    regressed = true;
+    return;
+  }
+
+  for (int r = 0; r < CPU_REPEATS; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    size_t n = decoder.begin(log_store, log_length)
+                   ? decoder.read(decoded, decoded_times, CPU_FRAMES)
+                   : 0;
+    auto t1 = std::chrono::steady_clock::now();
+    if (n != CPU_FRAMES) {
+      fprintf(stderr, "log %s: decoded %lu frames\n", op, (unsigned long)n);
+      regressed = true;
+      return;
+    }
+    best = fmin(best, std::chrono::duration<double>(t1 - t0).count());
+  }
+  for (size_t i = 0; i < CPU_FRAMES; i++) {
+    if (decoded_times[i] != times[i] ||
+        decoded[i].cycle_position != frames[i].cycle_position ||
+        memcmp(decoded[i].ram, frames[i].ram, 2 * words) != 0) {
+      fprintf(stderr, "log %s: frame %lu differs\n", op, (unsigned long)i);
+      regressed = true;
+      return;
+    }
+  }
+
+  double per_frame = (double)log_length / CPU_FRAMES;
+  printf("{\"kind\":\"log\",\"op\":\"%s\",\"bytes_per_frame\":%.2f,"
+         "\"ratio\":%.2f,\"ns_per_frame\":%.2f}\n",
+         op, per_frame, (2 * words + 4) / per_frame,
+         best * 1e9 / CPU_FRAMES);
+}
+
+/*!
+ *    @brief  Run all records
+ *    @param  argc Argument count
+ *    @param  argv Arguments
+ *    @return 0 on success, 1 on a regression or failure, 2 on bad usage
+ */
+int main(int argc, char** argv) {
+  if (argc == 3 && strcmp(argv[1], "--baseline") == 0) {
+    if (!loadBaseline(argv[2])) {
+      fprintf(stderr, "Can't read %s\n", argv[2]);
+      return 2;
+    }
+  } else if (argc != 1) {
+    fprintf(stderr, "Usage: %s [--baseline <file>]\n", argv[0]);
+    return 2;
+  }
+
+  measureBus("begin", 1, nullptr, runBegin);
+  measureBus("beginWarm", 1, setupBeginWarm, runBeginWarm);
+  measureBus("getCalibrations", 1, nullptr, runGetCalibrations);
+  measureBus("getAmbientTemperature", 1, nullptr, runGetAmbient);
+  measureBus("getObjectTemperature", 1, nullptr, runGetObject);
+  measureBus("readTemperatures", 1, nullptr, runReadTemperatures);
+  measureBus("readStatus", 1, nullptr, runReadStatus);
+  measureBus("poll", POLL_SAMPLES, setupPoll, runPoll);
+  measureBus("readFrameAsync", 1, nullptr, runReadFrameAsync);
+  measureCPU();
+  measureLog("medical_noise20", MLX90632_MEAS_MEDICAL, 20);
+  measureLog("medical_noise200", MLX90632_MEAS_MEDICAL, 200);
+  measureLog("extended_noise20", MLX90632_MEAS_EXTENDED_RANGE, 20);
+  measureLog("extended_noise200", MLX90632_MEAS_EXTENDED_RANGE, 200);
+
+  return regressed ? 1 : 0;
+}
@@ -0,0 +1,856 @@
+/*!
+ *  @file host_demo.cpp
+ *
+ *  Reads a simulated MLX90632 through the unmodified driver on the host, in
+ *  each measurement type and mode, and compares the temperatures with the
+ *  simulated ones.
+ *
+ *  Exits with status 1 if any reading is off by more than 0.05 degrees C.
+ *
+ *  Built with the mock transport (mlx90632_mock_demo), the driver talks to
+ *  the simulator through an mlx90632_mock_bus_t handler instead of the host
+ *  TwoWire, and readFrameAsync() runs on a deferred bus that completes the
+ *  descriptors after the call returned.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "Adafruit_MLX90632_Manager.h"
+#include "MLX90632_Simulator.h"
+
+#define TOLERANCE_C 0.05        ///< Allowed error, 1/4 of the medical spec
+#define SAMPLES 8               ///< Samples per temperature point
+#define HALF_FRAMES 64          ///< Medical frames for the half-cycle check
+#define BACKOFF_MS 250          ///< Time the sensor is unplugged while reading
+#define NOTIFY_SAMPLES 16       ///< Refresh periods per notification run
+#define HALF_NOISE 3            ///< RAM word noise for the half-cycle check
+#define HALF_SKIP 32            ///< Frame dropped in the half-cycle check
+#define HALF_RESYNC 4           ///< Frames after it to a known cycle position
+#define SOLVER_ITERATIONS 8     ///< Iteration limit for the solver check
+#define SOLVER_TOLERANCE_C 0.01 ///< Solver tolerance for the solver check
+#define SOLVER_AMBIENT_C 35.0   ///< Ambient for the solver check
+#define SOLVER_STEP_C 42.0      ///< Object temperature after the step
+#define MANAGER_PERIODS 8       ///< Refresh periods for the manager check
+
+static MLX90632_Simulator sensor;
+static Adafruit_MLX90632 mlx;
+static bool failed = false;
+
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+/*!
+ *    @brief  Mock bus handler that passes transactions to the simulator
+ *    @param  context The simulator
+ *    @param  addr Device address, the simulator answers any
+ *    @param  write_data Bytes written
+ *    @param  write_len Number of bytes written
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read
+ *    @return True if the simulator acknowledged
+ */
+static bool simulatorHandler(void* context, uint8_t addr,
+                             const uint8_t* write_data, size_t write_len,
+                             uint8_t* read_data, size_t read_len) {
+  MLX90632_Simulator* sim = static_cast<MLX90632_Simulator*>(context);
+
+  (void)addr;
+  if (!sim->i2cWrite(write_data, write_len, read_len == 0)) {
+    return false;
+  }
+  return read_len == 0 || sim->i2cRead(read_data, read_len);
+}
+
+static mlx90632_mock_bus_t bus = {
+    simulatorHandler, &sensor, HOST_WIRE_BUFFER_SIZE, false, {}, 0, 0};
+#define DEMO_BUS (&bus) ///< Bus the driver is started on
+
+/*!
+ *    @brief  A bus that can't carry one 16-bit word must fail register
+ *            reads instead of looping forever
+ */
+static void checkTinyBuffer() {
+  mlx90632_status_t status;
+
+  bus.max_buffer_size = 1;
+  bool ok = mlx.readStatus(&status);
+  bus.max_buffer_size = HOST_WIRE_BUFFER_SIZE;
+  printf("1-byte bus buffer: register read %s\n",
+         ok ? "succeeded, expected failure" : "refused");
+  if (ok) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Mock bus handler that NACKs everything, an unplugged sensor
+ *    @param  context Unused
+ *    @param  addr Unused
+ *    @param  write_data Unused
+ *    @param  write_len Unused
+ *    @param  read_data Unused
+ *    @param  read_len Unused
+ *    @return Always false
+ */
+static bool unpluggedHandler(void* context, uint8_t addr,
+                             const uint8_t* write_data, size_t write_len,
+                             uint8_t* read_data, size_t read_len) {
+  (void)context;
+  (void)addr;
+  (void)write_data;
+  (void)write_len;
+  (void)read_data;
+  (void)read_len;
+  return false;
+}
+#else
+#define DEMO_BUS (&Wire) ///< Bus the driver is started on
+#endif
+
+/*!
+ *    @brief  Unplug the simulated sensor from the bus or plug it back in
+ *    @param  connected False to make every transaction NACK
+ */
+static void setConnected(bool connected) {
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+  bus.handler = connected ? simulatorHandler : unpluggedHandler;
+#else
+  if (connected) {
+    Wire.attach(MLX90632_DEFAULT_ADDR, &sensor);
+  } else {
+    Wire.detach(MLX90632_DEFAULT_ADDR);
+  }
+#endif
+}
+
+/*!
+ *    @brief  Take samples with poll() and compare them with the simulator
+ *    @param  name Label for the output
+ *    @param  ambient Simulated ambient temperature
+ *    @param  object Simulated object temperature
+ */
+static void check(const char* name, double ambient, double object) {
+  double max_ta = 0, max_to = 0;
+  uint32_t start_transactions = mlx.getTransactionCount();
+  uint32_t start_ms = millis();
+
+  sensor.setAmbientTemperature(ambient);
+  sensor.setObjectTemperature(object);
+
+  // Let the first full table and the solver history settle
+  for (uint8_t i = 0; i < SAMPLES + 4; i++) {
+    while (mlx.poll() != MLX90632_STATE_READY) {
+      delay(1);
+    }
+    if (i < 4) {
+      start_transactions = mlx.getTransactionCount();
+      start_ms = millis();
+      continue;
+    }
+    max_ta = fmax(max_ta, fabs(mlx.getLastAmbientTemperature() - ambient));
+    max_to = fmax(max_to, fabs(mlx.getLastObjectTemperature() - object));
+  }
+
+  printf("%-20s TA %7.2f TO %7.2f  max error TA %.4f TO %.4f  "
+         "%.1f transactions/sample, %.1f ms/sample\n",
+         name, ambient, object, max_ta, max_to,
+         (double)(mlx.getTransactionCount() - start_transactions) / SAMPLES,
+         (double)(millis() - start_ms) / SAMPLES);
+  if (max_ta > TOLERANCE_C || max_to > TOLERANCE_C) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Run the temperature points in one configuration
+ *    @param  name Label for the output
+ *    @param  mode Measurement mode
+ *    @param  meas_select Measurement type
+ */
+static void run(const char* name, mlx90632_mode_t mode,
+                mlx90632_meas_select_t meas_select) {
+  static const double points[][2] = {
+      {25.0, 36.6}, {18.0, 20.0}, {30.0, 42.0}, {22.0, -10.0}, {40.0, 80.0}};
+
+  if (!mlx.setMode(mode) || !mlx.setMeasurementSelect(meas_select)) {
+    printf("%s: configuration failed\n", name);
+    failed = true;
+    return;
+  }
+  for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+    if (meas_select == MLX90632_MEAS_MEDICAL && points[i][1] > 50) {
+      continue;
+    }
+    check(name, points[i][0], points[i][1]);
+  }
+}
+
+/*!
+ *    @brief  Check that begin() with an exported calibration skips the
+ *            EEPROM reads and gives the same calibration as a cold start
+ */
+static void checkWarmStart() {
+  static mlx90632_cal_blob_t blob;
+  Adafruit_MLX90632 warm;
+
+  if (!mlx.exportCalibration(&blob) ||
+      !Adafruit_MLX90632::checkCalibration(blob)) {
+    printf("exportCalibration() failed\n");
+    failed = true;
+    return;
+  }
+  if (!warm.begin(blob, MLX90632_DEFAULT_ADDR, DEMO_BUS) ||
+      !warm.isWarmStarted() ||
+      memcmp(&warm.getCalibration(), &mlx.getCalibration(),
+             sizeof(mlx90632_calibration_t)) != 0) {
+    printf("warm begin() failed\n");
+    failed = true;
+    return;
+  }
+  printf("Warm begin(): %u-byte blob, %lu transactions\n",
+         (unsigned)sizeof(blob), (unsigned long)warm.getTransactionCount());
+
+  // A damaged blob falls back to reading the EEPROM
+  blob.ee[0] ^= 1;
+  if (!warm.begin(blob, MLX90632_DEFAULT_ADDR, DEMO_BUS) ||
+      warm.isWarmStarted()) {
+    printf("begin() with a damaged blob failed\n");
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Check that EEPROM sessions skip unchanged words, erase only
+ *            when needed, batch several words and restore the mode
+ */
+static void checkEEPROM() {
+  uint16_t customer = MLX90632_REG_CUSTOMER_DATA_START;
+  mlx90632_mode_t mode = mlx.getMode();
+  uint32_t cycles = sensor.getEEPROMCycles();
+
+  // Already set: no EEPROM cycle at all
+  if (!mlx.setRefreshRate(mlx.getRefreshRate()) || mlx.getEEPROMCycles() ||
+      sensor.getEEPROMCycles() != cycles) {
+    printf("EEPROM: unchanged refresh rate was written\n");
+    failed = true;
+  }
+
+  // One non-blocking session: an erased customer word (write only) and both
+  // EE_MEAS words (erase and write each)
+  uint32_t start_ms = millis();
+  if (!mlx.beginEEPROMWrite() ||
+      mlx.writeEEPROM(MLX90632_REG_EE_P_R_LSW, 0) ||
+      !mlx.writeEEPROM(customer, 0xBEEF) ||
+      !mlx.writeEEPROM(MLX90632_REG_EE_MEAS_1, MLX90632_REFRESH_4HZ << 8,
+                       mlx90632_ee_meas1_refresh_t::mask()) ||
+      !mlx.writeEEPROM(MLX90632_REG_EE_MEAS_2, MLX90632_REFRESH_4HZ << 8,
+                       mlx90632_ee_meas2_refresh_t::mask()) ||
+      !mlx.commitEEPROM(false)) {
+    printf("EEPROM: session failed to start\n");
+    failed = true;
+    return;
+  }
+  mlx90632_eeprom_state_t state;
+  while ((state = mlx.pollEEPROM()) != MLX90632_EEPROM_DONE &&
+         state != MLX90632_EEPROM_FAILED) {
+    delay(1);
+  }
+  if (state == MLX90632_EEPROM_FAILED) {
+    printf("EEPROM: session failed\n");
+    failed = true;
+    return;
+  }
+  printf("EEPROM session: %u cycles in %lu ms\n", mlx.getEEPROMCycles(),
+         (unsigned long)(millis() - start_ms));
+
+  if (mlx.getEEPROMCycles() != 5 || sensor.peek(customer) != 0xBEEF ||
+      mlx.getRefreshRate() != MLX90632_REFRESH_4HZ ||
+      ((sensor.peek(MLX90632_REG_EE_MEAS_2) >> 8) & 0x7) !=
+          MLX90632_REFRESH_4HZ ||
+      mlx.getMode() != mode ||
+      ((sensor.peek(MLX90632_REG_CONTROL) >> 1) & 0x3) != mode) {
+    printf("EEPROM: wrong contents or mode after the session\n");
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  A blocking EEPROM session on an EEPROM that never leaves busy
+ *            must fail within the timeout and restore the mode
+ */
+static void checkEEPROMTimeout() {
+  uint16_t customer = MLX90632_REG_CUSTOMER_DATA_START;
+  mlx90632_mode_t mode = mlx.getMode();
+  uint32_t allowed = mlx.getRefreshPeriod() + 2 * MLX90632_EEPROM_TIMEOUT_MS;
+
+  sensor.setEEPROMStuck(true);
+  uint32_t start_ms = millis();
+  bool ok = mlx.beginEEPROMWrite() && mlx.writeEEPROM(customer, 0x1234) &&
+            mlx.commitEEPROM(true);
+  uint32_t elapsed = millis() - start_ms;
+  sensor.setEEPROMStuck(false);
+  delay(MLX90632_EEPROM_TIMEOUT_MS);
+
+  printf("EEPROM stuck busy: session %s after %lu ms (allowed %lu)\n",
+         ok ? "completed" : "failed", (unsigned long)elapsed,
+         (unsigned long)allowed);
+  if (ok || mlx.pollEEPROM() != MLX90632_EEPROM_FAILED || elapsed > allowed ||
+      mlx.getMode() != mode ||
+      ((sensor.peek(MLX90632_REG_CONTROL) >> 1) & 0x3) != mode) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  readFrameAsync() callback
+ *    @param  context Where to store the result
+ *    @param  result How the chain ended
+ *    @param  sample The sample
+ */
+static void asyncDone(void* context, mlx90632_async_result_t result,
+                      const mlx90632_sample_t* sample) {
+  (void)sample;
+  *static_cast<int*>(context) = result;
+}
+
+/*!
+ *    @brief  Take samples with readFrameAsync() and compare them with the
+ *            simulator. On the mock transport the bus is deferred, so the
+ *            chain must still be pending when readFrameAsync() returns.
+ */
+static void checkAsync() {
+  double max_ta = 0, max_to = 0;
+  uint32_t transactions = 0;
+  uint32_t pending = 0;
+  int result = -1;
+
+  sensor.setAmbientTemperature(25.0);
+  sensor.setObjectTemperature(36.6);
+  if (!mlx.setMode(MLX90632_MODE_CONTINUOUS) ||
+      !mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL)) {
+    printf("async: configuration failed\n");
+    failed = true;
+    return;
+  }
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+  bus.deferred = true;
+#endif
+
+  for (uint8_t i = 0; i < SAMPLES + 4;) {
+    uint32_t start = mlx.getTransactionCount();
+
+    result = -1;
+    if (!mlx.readFrameAsync(asyncDone, &result)) {
+      printf("readFrameAsync() failed to start\n");
+      failed = true;
+      break;
+    }
+    if (result == -1 && mlx.isAsyncBusy()) {
+      pending++;
+    }
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+    // Stand-in for the DMA completion interrupts
+    while (Adafruit_MLX90632_MockTransport::completeNext(&bus)) {
+    }
+#endif
+    if (result == MLX90632_ASYNC_NO_DATA) {
+      delay(1);
+      continue;
+    }
+    if (result != MLX90632_ASYNC_DONE) {
+      printf("readFrameAsync() failed\n");
+      failed = true;
+      break;
+    }
+    // Let the solver history settle
+    if (i++ < 4) {
+      continue;
+    }
+    transactions += mlx.getTransactionCount() - start;
+    max_ta = fmax(max_ta, fabs(mlx.getLastAmbientTemperature() - 25.0));
+    max_to = fmax(max_to, fabs(mlx.getLastObjectTemperature() - 36.6));
+  }
+
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+  bus.deferred = false;
+#endif
+  printf("Async frames: max error TA %.4f TO %.4f, %.1f transactions/sample, "
+         "%s\n",
+         max_ta, max_to, (double)transactions / SAMPLES,
+         pending ? "completed in the background" : "completed in the call");
+  if (max_ta > TOLERANCE_C || max_to > TOLERANCE_C) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Unplug the sensor while poll() is about to read a frame. The
+ *            retries must back off by an eighth of the refresh period
+ *            instead of hitting the bus on every call, and poll() must
+ *            recover once the sensor is back.
+ */
+static void checkReadBackoff() {
+  uint32_t start, limit;
+
+  if (!mlx.setMode(MLX90632_MODE_CONTINUOUS) ||
+      !mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL)) {
+    printf("read backoff: configuration failed\n");
+    failed = true;
+    return;
+  }
+  while (mlx.poll() != MLX90632_STATE_READING) {
+    delay(1);
+  }
+
+  setConnected(false);
+  start = mlx.getTransactionCount();
+  for (uint16_t i = 0; i < BACKOFF_MS; i++) {
+    mlx.poll();
+    delay(1);
+  }
+  uint32_t attempts = mlx.getTransactionCount() - start;
+  setConnected(true);
+
+  limit = millis() + 4 * mlx.getRefreshPeriod();
+  while (mlx.poll() != MLX90632_STATE_READY && millis() < limit) {
+    delay(1);
+  }
+  bool recovered = mlx.getPollState() == MLX90632_STATE_READY;
+  uint32_t allowed = BACKOFF_MS / (mlx.getRefreshPeriod() / 8) + 2;
+  printf("Unplugged frame read: %lu bus attempts in %u ms (at most %lu), "
+         "%s\n",
+         (unsigned long)attempts, BACKOFF_MS, (unsigned long)allowed,
+         recovered ? "recovered" : "did not recover");
+  if (attempts > allowed || !recovered) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Wait for a sample in polled mode, then switch to data-ready
+ *            notification mode
+ */
+static void startNotify() {
+  mlx.setDataReadyNotify(false);
+  while (mlx.poll() != MLX90632_STATE_READY) {
+    delay(1);
+  }
+  mlx.setDataReadyNotify(true);
+}
+
+/*!
+ *    @brief  Take samples in data-ready notification mode, with a timer
+ *            that fires every refresh period from one period after the
+ *            first sample
+ *    @param  samples Samples taken in NOTIFY_SAMPLES refresh periods
+ *    @return Status reads made
+ */
+static uint32_t notifyRun(uint32_t* samples) {
+  uint16_t period = mlx.getRefreshPeriod();
+  bool was_ready = false;
+
+  startNotify();
+  uint32_t start = mlx.getStatusReadCount();
+  uint32_t next = millis() + period;
+  uint32_t end = millis() + NOTIFY_SAMPLES * period + period / 2;
+  *samples = 0;
+  while (millis() < end) {
+    if (millis() >= next) {
+      mlx.notifyDataReady();
+      next += period;
+    }
+    bool ready = mlx.poll() == MLX90632_STATE_READY;
+    if (ready && !was_ready) {
+      (*samples)++;
+    }
+    was_ready = ready;
+    delay(1);
+  }
+  mlx.setDataReadyNotify(false);
+  return mlx.getStatusReadCount() - start;
+}
+
+/*!
+ *    @brief  Send a single notification half a refresh period after a
+ *            sample, well before the next one is ready
+ *    @param  reads Status reads made until the sample was taken
+ *    @return True if the sample was taken within one refresh period
+ */
+static bool notifyEarly(uint32_t* reads) {
+  uint16_t period = mlx.getRefreshPeriod();
+  bool ready = false;
+
+  startNotify();
+  uint32_t start = mlx.getStatusReadCount();
+  delay(period / 2);
+  mlx.notifyDataReady();
+  uint32_t end = millis() + period;
+  while (!ready && millis() < end) {
+    ready = mlx.poll() == MLX90632_STATE_READY;
+    delay(1);
+  }
+  mlx.setDataReadyNotify(false);
+  *reads = mlx.getStatusReadCount() - start;
+  return ready;
+}
+
+/*!
+ *    @brief  Data-ready notification must cost one status read per sample
+ *            with a well-timed notification. An early one must stay
+ *            pending and fall back to the status backoff instead of
+ *            dropping the sample.
+ */
+static void checkNotify() {
+  uint32_t samples, reads, early_reads;
+
+  if (!mlx.setMode(MLX90632_MODE_CONTINUOUS) ||
+      !mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL)) {
+    printf("notify: configuration failed\n");
+    failed = true;
+    return;
+  }
+  reads = notifyRun(&samples);
+  bool early_ready = notifyEarly(&early_reads);
+  printf("Notified: %lu samples, %lu status reads; notified early: %s after "
+         "%lu status reads\n",
+         (unsigned long)samples, (unsigned long)reads,
+         early_ready ? "sampled" : "no sample", (unsigned long)early_reads);
+  // Half a period early, backing off by an eighth: about four reads
+  if (samples != NOTIFY_SAMPLES || reads != NOTIFY_SAMPLES || !early_ready ||
+      early_reads < 2 || early_reads > 6) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Convert noisy medical frames three ways: with their cycle
+ *            positions, with both halves averaged (which must stay within
+ *            tolerance with less spread), and in a batch with every cycle
+ *            position after the first cleared, where the inferred
+ *            half-cycles must give bit-identical results. Then drop one
+ *            frame, as a late read would: the frames after the gap must
+ *            give NaN until a cycle position is known again.
+ */
+static void checkHalfCycles() {
+  mlx90632_frame_t frames[HALF_FRAMES];
+  uint32_t times[HALF_FRAMES];
+  mlx90632_real_t ambient[HALF_FRAMES];
+  mlx90632_real_t object[3][HALF_FRAMES];
+  mlx90632_solver_t solver;
+  mlx90632_sample_t sample;
+  double max_to = 0, spread[2] = {0, 0};
+  bool identical = true, skipped = true;
+
+  sensor.setAmbientTemperature(25.0);
+  sensor.setObjectTemperature(36.6);
+  sensor.setNoise(HALF_NOISE);
+  if (!mlx.setMode(MLX90632_MODE_CONTINUOUS) ||
+      !mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL)) {
+    printf("half-cycles: configuration failed\n");
+    failed = true;
+    sensor.setNoise(0);
+    return;
+  }
+  for (uint8_t i = 0; i < HALF_FRAMES; i++) {
+    while (mlx.poll() != MLX90632_STATE_READY) {
+      delay(1);
+    }
+    mlx.getLastSample(&sample);
+    frames[i] = sample.frame;
+    times[i] = sample.timestamp_ms;
+  }
+  sensor.setNoise(0);
+
+  const mlx90632_calibration_t& cal = mlx.getCalibration();
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    Adafruit_MLX90632::initSolver(&solver);
+    solver.average_halves = pass == 1;
+    for (uint8_t i = 0; i < HALF_FRAMES; i++) {
+      object[2 * pass][i] =
+          Adafruit_MLX90632::computeObject(frames[i], cal, &solver);
+    }
+  }
+  uint8_t resync_position = frames[HALF_SKIP + HALF_RESYNC].cycle_position;
+  for (uint8_t i = 1; i < HALF_FRAMES; i++) {
+    frames[i].cycle_position = 0;
+  }
+  Adafruit_MLX90632::initSolver(&solver);
+  solver.period_ms = mlx.getRefreshPeriod();
+  Adafruit_MLX90632::computeBatch(frames, HALF_FRAMES, cal, &solver, ambient,
+                                  object[1], times);
+
+  for (uint8_t i = 4; i < HALF_FRAMES; i++) {
+    identical = identical && object[0][i] == object[1][i];
+    max_to = fmax(max_to, fabs(object[2][i] - 36.6));
+    spread[0] += (object[0][i] - 36.6) * (object[0][i] - 36.6);
+    spread[1] += (object[2][i] - 36.6) * (object[2][i] - 36.6);
+  }
+
+  // Drop frame HALF_SKIP, then give the frame HALF_RESYNC later its
+  // cycle position back
+  for (uint8_t i = HALF_SKIP; i < HALF_FRAMES - 1; i++) {
+    frames[i] = frames[i + 1];
+    times[i] = times[i + 1];
+  }
+  frames[HALF_SKIP + HALF_RESYNC - 1].cycle_position = resync_position;
+  Adafruit_MLX90632::initSolver(&solver);
+  solver.period_ms = mlx.getRefreshPeriod();
+  Adafruit_MLX90632::computeBatch(frames, HALF_FRAMES - 1, cal, &solver,
+                                  ambient, object[1], times);
+  for (uint8_t i = 4; i < HALF_FRAMES - 1; i++) {
+    if (i < HALF_SKIP) {
+      skipped = skipped && object[1][i] == object[0][i];
+    } else if (i < HALF_SKIP + HALF_RESYNC - 1) {
+      skipped = skipped && isnan(object[1][i]);
+    } else {
+      skipped = skipped && fabs(object[1][i] - 36.6) <= TOLERANCE_C;
+    }
+  }
+
+  printf("Half-cycles: inferred halves %s, after a skipped frame %s, "
+         "averaged max error TO %.4f, RMS %.4f -> %.4f\n",
+         identical ? "match" : "DIFFER", skipped ? "NaN" : "WRONG", max_to,
+         sqrt(spread[0] / (HALF_FRAMES - 4)),
+         sqrt(spread[1] / (HALF_FRAMES - 4)));
+  if (!identical || !skipped || max_to > TOLERANCE_C ||
+      spread[1] >= spread[0]) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Wait for the next poll() sample
+ *    @return Its object temperature
+ */
+static double nextObject() {
+  while (mlx.poll() != MLX90632_STATE_READY) {
+    delay(1);
+  }
+  return mlx.getLastObjectTemperature();
+}
+
+/*!
+ *    @brief  Iterate the object temperature solver: warm-started from the
+ *            previous sample it must stop after one or two iterations, the
+ *            sample after a step in object temperature must converge to
+ *            the solver's fixed point within its tolerance, and
+ *            getSolverIterations() must report the iterations that ran
+ */
+static void checkSolver() {
+  double max_to = 0, step_to, fixed_to;
+  uint8_t max_warm = 0, step_iterations, forced, restored;
+  mlx90632_solver_t before;
+
+  if (mlx.setSolver(0) || mlx.setSolver(SOLVER_ITERATIONS, -1) ||
+      !mlx.setSolver(SOLVER_ITERATIONS, SOLVER_TOLERANCE_C) ||
+      !mlx.setMode(MLX90632_MODE_CONTINUOUS) ||
+      !mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL)) {
+    printf("solver: configuration failed\n");
+    failed = true;
+    mlx.setSolver(1);
+    return;
+  }
+  // The simulator inverts the single-pass steady state, which is off from
+  // the iterated one by about Ga * (TO - TA); an ambient close to the
+  // object keeps that well within TOLERANCE_C
+  sensor.setAmbientTemperature(SOLVER_AMBIENT_C);
+  sensor.setObjectTemperature(36.6);
+  for (uint8_t i = 0; i < SAMPLES + 4; i++) {
+    double to = nextObject();
+    if (i >= 4) {
+      max_to = fmax(max_to, fabs(to - 36.6));
+      if (mlx.getSolverIterations() > max_warm) {
+        max_warm = mlx.getSolverIterations();
+      }
+    }
+  }
+
+  before = mlx.getSolverState();
+  sensor.setObjectTemperature(SOLVER_STEP_C);
+  step_to = nextObject();
+  step_iterations = mlx.getSolverIterations();
+
+  // Iterate the same frame from the same history until nothing changes
+  before.max_iterations = 100;
+  before.tolerance = 0;
+  fixed_to = Adafruit_MLX90632::computeObject(mlx.getLastFrame(),
+                                              mlx.getCalibration(), &before);
+
+  for (uint8_t i = 0; i < SAMPLES; i++) {
+    max_to = fmax(max_to, fabs(nextObject() - SOLVER_STEP_C));
+    if (mlx.getSolverIterations() > max_warm) {
+      max_warm = mlx.getSolverIterations();
+    }
+  }
+
+  // A tolerance of 0 is never met, so every iteration runs
+  mlx.setSolver(3, 0);
+  nextObject();
+  forced = mlx.getSolverIterations();
+  forced = forced == mlx.getSolverState().iterations ? forced : 0;
+  mlx.setSolver(1);
+  nextObject();
+  restored = mlx.getSolverIterations();
+
+  printf("Solver: step to %.1f gives %.4f (fixed point %.4f) after %u "
+         "iterations, max error TO %.4f, warm-started %u iterations at most, "
+         "forced %u, single %u\n",
+         SOLVER_STEP_C, step_to, fixed_to, step_iterations, max_to, max_warm,
+         forced, restored);
+  if (fabs(step_to - fixed_to) > SOLVER_TOLERANCE_C ||
+      fabs(step_to - SOLVER_STEP_C) > TOLERANCE_C || max_to > TOLERANCE_C ||
+      step_iterations < 2 || step_iterations >= SOLVER_ITERATIONS ||
+      max_warm < 1 || max_warm > 2 || forced != 3 || restored != 1) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  readFrame() without a status snapshot must fail when its status
+ *            read fails, instead of reading a medical frame as cycle
+ *            position 0
+ */
+static void checkFrameStatus() {
+  mlx90632_frame_t frame;
+  bool first, second;
+
+  if (!mlx.setMeasurementSelect(MLX90632_MEAS_MEDICAL)) {
+    printf("frame status: configuration failed\n");
+    failed = true;
+    return;
+  }
+  sensor.failReads(1);
+  first = mlx.readFrame(&frame);
+  sensor.failReads(0);
+  second = mlx.readFrame(&frame);
+
+  printf("Frame with a failed status read: %s, then %s\n",
+         first ? "read" : "failed", second ? "read" : "failed");
+  if (first || !second || frame.cycle_position == 0) {
+    failed = true;
+  }
+}
+
+static uint32_t manager_selects = 0;
+
+/*!
+ *    @brief  Bus select callback that counts the manager's sensor accesses
+ *    @param  channel Unused
+ */
+static void countSelect(uint8_t channel) {
+  (void)channel;
+  manager_selects++;
+}
+
+/*!
+ *    @brief  The manager must look at a halted sensor once per refresh
+ *            period instead of on every update(), and pick it up again
+ *            once it measures
+ */
+static void checkManagerHalted() {
+  Adafruit_MLX90632_Manager manager;
+  uint32_t period = mlx.getRefreshPeriod();
+  uint32_t halted_selects, samples = 0;
+
+  if (!mlx.setMode(MLX90632_MODE_HALT) ||
+      !manager.addSensor(&mlx, countSelect)) {
+    printf("manager: configuration failed\n");
+    failed = true;
+    return;
+  }
+  manager.begin();
+  manager_selects = 0;
+  for (uint32_t i = 0; i < MANAGER_PERIODS * period; i++) {
+    samples += manager.update();
+    delay(1);
+  }
+  halted_selects = manager_selects;
+
+  mlx.setMode(MLX90632_MODE_CONTINUOUS);
+  for (uint32_t i = 0; i < MANAGER_PERIODS * period; i++) {
+    samples += manager.update();
+    delay(1);
+  }
+
+  printf("Manager: %lu bus selects in %u halted periods, then %lu samples\n",
+         (unsigned long)halted_selects, MANAGER_PERIODS,
+         (unsigned long)samples);
+  if (halted_selects > MANAGER_PERIODS + 1 ||
+      samples < MANAGER_PERIODS - 2) {
+    failed = true;
+  }
+}
+
+/*!
+ *    @brief  Run every configuration against the simulator
+ *    @return 0 if all readings were within tolerance, 1 otherwise
+ */
+int main() {
+  sensor.begin();
+
+  if (!mlx.begin(MLX90632_DEFAULT_ADDR, DEMO_BUS)) {
+    printf("begin() failed\n");
+    return 1;
+  }
+  printf("Product ID 0x%012llX, product code 0x%04X, EEPROM version 0x%04X\n",
+         (unsigned long long)mlx.getProductID(), mlx.getProductCode(),
+         mlx.getEEPROMVersion());
+
+  checkWarmStart();
+#if MLX90632_TRANSPORT == MLX90632_TRANSPORT_MOCK
+  checkTinyBuffer();
+#endif
+
+  if (!mlx.setRefreshRate(MLX90632_REFRESH_8HZ)) {
+    printf("setRefreshRate() failed\n");
+    return 1;
+  }
+
+  checkEEPROM();
+  checkEEPROMTimeout();
+  if (!mlx.setRefreshRate(MLX90632_REFRESH_8HZ)) {
+    printf("setRefreshRate() failed\n");
+    return 1;
+  }
+
+  run("medical/continuous", MLX90632_MODE_CONTINUOUS, MLX90632_MEAS_MEDICAL);
+  run("medical/step", MLX90632_MODE_STEP, MLX90632_MEAS_MEDICAL);
+  run("extended/continuous", MLX90632_MODE_CONTINUOUS,
+      MLX90632_MEAS_EXTENDED_RANGE);
+  run("extended/step", MLX90632_MODE_STEP, MLX90632_MEAS_EXTENDED_RANGE);
+  checkReadBackoff();
+  checkNotify();
+  checkAsync();
+  checkHalfCycles();
+  checkSolver();
+  checkFrameStatus();
+  checkManagerHalted();
+
+#ifdef MLX90632_STATS
+  const mlx90632_stats_t& stats = mlx.getStats();
+  printf("Stats: %lu transactions, %lu failed reads, %lu failed writes, "
+         "%lu frames (cycle position 1: %lu, 2: %lu, other: %lu)\n",
+         (unsigned long)stats.transactions, (unsigned long)stats.failed_reads,
+         (unsigned long)stats.failed_writes, (unsigned long)stats.frames,
+         (unsigned long)stats.cycle_position[1],
+         (unsigned long)stats.cycle_position[2],
+         (unsigned long)(stats.cycle_position[0] + stats.cycle_position[3]));
+  printf("       NaN: %lu read failed, %lu cycle position, %lu math\n",
+         (unsigned long)stats.nan_read_failed,
+         (unsigned long)stats.nan_cycle_position,
+         (unsigned long)stats.nan_math);
+  printf("       latency %lu samples, min %lu us, mean %lu us, max %lu us, "
+         "histogram",
+         (unsigned long)stats.latency_count,
+         (unsigned long)stats.latency_min_us,
+         (unsigned long)(stats.latency_count
+                             ? stats.latency_total_us / stats.latency_count
+                             : 0),
+         (unsigned long)stats.latency_max_us);
+  for (uint8_t i = 0; i < MLX90632_STATS_BUCKETS; i++) {
+    printf(" %lu", (unsigned long)stats.latency_histogram[i]);
+  }
+  printf("\n");
+#endif
+
+  printf("%s\n", failed ? "FAILED" : "OK");
+  return failed ? 1 : 0;
+}
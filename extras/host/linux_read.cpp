@@ -0,0 +1,58 @@
+/*!
+ *  @file linux_read.cpp
+ *
+ *  Reads a real MLX90632 from Linux through the i2c-dev transport.
+ *
+ *  Usage: mlx90632_linux_read [device] [address] [seconds]
+ *
+ *  Defaults to /dev/i2c-1, 0x3A and 10 seconds. Prints the product ID and
+ *  one line per sample. The adapter must support plain I2C messages
+ *  (I2C_FUNC_I2C); SMBus-only adapters such as i2c-stub are refused by
+ *  begin(). Exits with status 1 if begin() fails.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "Adafruit_MLX90632.h"
+
+/*!
+ *    @brief  Open the sensor and print samples
+ *    @param  argc Argument count
+ *    @param  argv Arguments: device, address, run time in seconds
+ *    @return 0, or 1 if begin() failed
+ */
+int main(int argc, char** argv) {
+  const char* device = MLX90632_LINUX_DEFAULT_DEVICE;
+  uint8_t addr = MLX90632_DEFAULT_ADDR;
+  unsigned long run_ms = 10000;
+  Adafruit_MLX90632 mlx;
+
+  if (argc > 1) {
+    device = argv[1];
+  }
+  if (argc > 2) {
+    addr = (uint8_t)strtoul(argv[2], nullptr, 0);
+  }
+  if (argc > 3) {
+    run_ms = strtoul(argv[3], nullptr, 10) * 1000UL;
+  }
+
+  if (!mlx.begin(addr, device)) {
+    fprintf(stderr, "No MLX90632 at 0x%02X on %s\n", addr, device);
+    return 1;
+  }
+  printf("Product ID 0x%012llX, product code 0x%04X, EEPROM version 0x%04X\n",
+         (unsigned long long)mlx.getProductID(), mlx.getProductCode(),
+         mlx.getEEPROMVersion());
+
+  run_ms += millis();
+  while (millis() < run_ms) {
+    if (mlx.poll() == MLX90632_STATE_READY) {
+      printf("%10lu ms  TA %7.2f C  TO %7.2f C\n", millis(),
+             mlx.getLastAmbientTemperature(), mlx.getLastObjectTemperature());
+    } else {
+      delay(1);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*!
+ *  @file precision_sweep.cpp
+ *
+ *  Generates the numeric precision table in README.md. Sweeps ambient
+ *  -18..82 degrees C and object -70..200 degrees C through the simulator,
+ *  whose EEPROM holds the datasheet example calibration, in extended range
+ *  mode. Each frame is converted with fresh TO0/TA0 state, so the error of
+ *  one sample doesn't carry into the next.
+ *
+ *  Usage: mlx90632_precision [--reference <file>]
+ *
+ *  Without arguments it prints one line per point: ambient, object, and the
+ *  converted ambient and object temperatures at full precision. Built as
+ *  mlx90632_precision_single (with MLX90632_SINGLE_PRECISION) and given the
+ *  output of the double build as reference, it converts the same frames in
+ *  float and prints the largest differences as the README table:
+ *
+ *    ./build/mlx90632_precision > double.txt
+ *    ./build/mlx90632_precision_single --reference double.txt
+ *
+ *  Exits with status 1 if the sensor setup fails or the reference doesn't
+ *  match the sweep.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "MLX90632_Simulator.h"
+
+#define AMBIENT_MIN -18 ///< First ambient point
+#define AMBIENT_MAX 82  ///< Last ambient point
+#define AMBIENT_STEP 2  ///< Ambient step
+#define OBJECT_MIN -70  ///< First object point
+#define OBJECT_MAX 200  ///< Last object point
+#define OBJECT_STEP 1   ///< Object step
+
+/*!
+ *    @brief  Object ranges of the table, each up to the next one's start
+ */
+static const int range_start[] = {-70, 0, 35, 42, 100};
+#define RANGES ((uint8_t)(sizeof(range_start) / sizeof(range_start[0])))
+
+static MLX90632_Simulator sensor;
+static Adafruit_MLX90632 mlx;
+
+/*!
+ *    @brief  Get the table row of an object temperature
+ *    @param  object Object temperature in degrees Celsius
+ *    @return Index into range_start
+ */
+static uint8_t rangeOf(int object) {
+  uint8_t range = 0;
+
+  while (range + 1 < RANGES && object >= range_start[range + 1]) {
+    range++;
+  }
+  return range;
+}
+
+/*!
+ *    @brief  Measure one point and convert it with a fresh solver
+ *    @param  ambient Simulated ambient temperature
+ *    @param  object Simulated object temperature
+ *    @param  ta Converted ambient temperature
+ *    @param  to Converted object temperature
+ */
+static void convert(int ambient, int object, double* ta, double* to) {
+  mlx90632_solver_t solver;
+
+  sensor.setAmbientTemperature(ambient);
+  sensor.setObjectTemperature(object);
+  while (mlx.poll() != MLX90632_STATE_READY) {
+    delay(1);
+  }
+  // The frame finished after the temperatures were set
+  while (mlx.poll() != MLX90632_STATE_READY) {
+    delay(1);
+  }
+  const mlx90632_frame_t& frame = mlx.getLastFrame();
+  const mlx90632_calibration_t& cal = mlx.getCalibration();
+  Adafruit_MLX90632::initSolver(&solver);
+  *ta = Adafruit_MLX90632::computeAmbient(frame, cal);
+  *to = Adafruit_MLX90632::computeObject(frame, cal, &solver);
+}
+
+/*!
+ *    @brief  Run the sweep
+ *    @param  argc Argument count
+ *    @param  argv Arguments
+ *    @return 0 on success, 1 if the sweep failed, 2 for bad arguments
+ */
+int main(int argc, char** argv) {
+  FILE* reference = nullptr;
+  double max_ta = 0, max_to[RANGES] = {0};
+
+  if (argc == 3 && strcmp(argv[1], "--reference") == 0) {
+    reference = fopen(argv[2], "r");
+    if (!reference) {
+      fprintf(stderr, "Can't read %s\n", argv[2]);
+      return 2;
+    }
+  } else if (argc != 1) {
+    fprintf(stderr, "Usage: %s [--reference <file>]\n", argv[0]);
+    return 2;
+  }
+
+  sensor.begin();
+  if (!mlx.begin(MLX90632_DEFAULT_ADDR, &Wire) ||
+      !mlx.setRefreshRate(MLX90632_REFRESH_64HZ) ||
+      !mlx.setMode(MLX90632_MODE_CONTINUOUS) ||
+      !mlx.setMeasurementSelect(MLX90632_MEAS_EXTENDED_RANGE)) {
+    fprintf(stderr, "Sensor setup failed\n");
+    return 1;
+  }
+
+  for (int ambient = AMBIENT_MIN; ambient <= AMBIENT_MAX;
+       ambient += AMBIENT_STEP) {
+    for (int object = OBJECT_MIN; object <= OBJECT_MAX;
+         object += OBJECT_STEP) {
+      double ta, to, ref_ta, ref_to;
+      int ref_ambient, ref_object;
+
+      convert(ambient, object, &ta, &to);
+      if (!reference) {
+        printf("%d %d %.17g %.17g\n", ambient, object, ta, to);
+        continue;
+      }
+      if (fscanf(reference, "%d %d %lf %lf", &ref_ambient, &ref_object,
+                 &ref_ta, &ref_to) != 4 ||
+          ref_ambient != ambient || ref_object != object) {
+        fprintf(stderr, "Reference doesn't match the sweep at %d/%d\n",
+                ambient, object);
+        return 1;
+      }
+      uint8_t range = rangeOf(object);
+      max_ta = fmax(max_ta, fabs(ta - ref_ta));
+      max_to[range] = fmax(max_to[range], fabs(to - ref_to));
+    }
+  }
+  if (!reference) {
+    return 0;
+  }
+  fclose(reference);
+
+  printf("| Object range   | max \\|ΔTO\\| (°C) |\n");
+  printf("|----------------|------------------|\n");
+  for (uint8_t i = 0; i < RANGES; i++) {
+    char label[16];
+    snprintf(label, sizeof(label), "%d .. %d °C", range_start[i],
+             i + 1 < RANGES ? range_start[i + 1] : OBJECT_MAX);
+    // The degree sign takes two bytes but one column
+    printf("| %-16s| %-16.1e |\n", label, max_to[i]);
+  }
+  printf("\nAmbient temperature differs by at most %.1e °C.\n", max_ta);
+  return 0;
+}
@@ -0,0 +1,170 @@
+/*!
+ *  @file ring_demo.cpp
+ *
+ *  Checks Adafruit_MLX90632_SampleRing: batched pops, overrun counting on
+ *  a full ring and index wraparound, with the host's index type and with
+ *  the uint8_t index AVR uses, at the largest ring it allows. A producer
+ *  thread then pushes while the main thread pops, as an interrupt or a
+ *  second core would.
+ *
+ *  Exits with status 1 if a sample is lost, duplicated or reordered.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include <thread>
+
+#include "Adafruit_MLX90632_SampleRing.h"
+
+#define WRAPS 4               ///< Times the ring indices wrap around
+#define THREAD_SAMPLES 100000 ///< Samples handed between the threads
+
+static bool failed = false;
+
+/*!
+ *    @brief  Make a sample that carries a sequence number
+ *    @param  seq Sequence number
+ *    @return The sample
+ */
+static mlx90632_sample_t makeSample(uint32_t seq) {
+  mlx90632_sample_t sample = {};
+
+  sample.timestamp_ms = seq;
+  sample.frame.ram[0] = (int16_t)seq;
+  return sample;
+}
+
+/*!
+ *    @brief  Check that popped samples continue a sequence
+ *    @param  out Popped samples
+ *    @param  n Number of samples
+ *    @param  seq Next expected sequence number, advanced by n
+ *    @return True if the samples were in order
+ */
+static bool inSequence(const mlx90632_sample_t* out, size_t n,
+                       uint32_t* seq) {
+  for (size_t i = 0; i < n; i++) {
+    if (out[i].timestamp_ms != *seq ||
+        out[i].frame.ram[0] != (int16_t)*seq) {
+      return false;
+    }
+    (*seq)++;
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Fill, overrun and drain a ring, then push and pop in uneven
+ *            batches until the indices have wrapped a few times
+ *    @tparam N Capacity of the ring
+ *    @tparam Index Index type of the ring
+ *    @param  name Shown in the output
+ */
+template <size_t N, typename Index> static void checkRing(const char* name) {
+  static Adafruit_MLX90632_SampleRing<N, Index> ring;
+  static mlx90632_sample_t out[N];
+  uint32_t index_range = (uint32_t)(Index)~(Index)0 + 1;
+  uint32_t pushed = 0, popped = 0, dropped = 0;
+  bool ok = true;
+
+  // Full ring: the extra sample is dropped and counted
+  for (size_t i = 0; i < N; i++) {
+    ok &= ring.push(makeSample(pushed++));
+  }
+  ok &= ring.available() == N;
+  ok &= !ring.push(makeSample(pushed)) && ring.getOverruns() == 1;
+  ok &= ring.available() == N;
+  dropped = 1;
+
+  // Drain in batches of three
+  while (ring.available()) {
+    Index waiting = ring.available();
+    Index n = ring.pop(out, 3);
+    ok &= n == (waiting < 3 ? waiting : 3);
+    ok &= inSequence(out, n, &popped);
+  }
+  ok &= popped == N && ring.pop(out, N) == 0;
+
+  // Uneven batches until the indices have wrapped a few times
+  pushed = popped;
+  for (uint32_t round = 0; ok && popped < WRAPS * index_range; round++) {
+    size_t push_n = (round * 7) % (N + N / 2 + 1);
+    for (size_t i = 0; i < push_n; i++) {
+      if (ring.push(makeSample(pushed))) {
+        pushed++;
+      } else {
+        dropped++;
+      }
+    }
+    ok &= ring.available() <= N;
+    Index n = ring.pop(out, (Index)((round * 5) % N + 1));
+    ok &= inSequence(out, n, &popped);
+  }
+  Index n = ring.pop(out, N);
+  ok &= inSequence(out, n, &popped);
+  ok &= popped == pushed && ring.getOverruns() == dropped;
+
+  ring.resetOverruns();
+  ok &= ring.getOverruns() == 0;
+
+  printf("%s: %lu samples, %lu overruns: %s\n", name, (unsigned long)popped,
+         (unsigned long)dropped, ok ? "OK" : "FAILED");
+  failed |= !ok;
+}
+
+/*!
+ *    @brief  Push from a second thread while this one pops. The producer
+ *            retries a sample the ring had no room for; both yield when
+ *            they can't go on, so this also runs on a single core.
+ *    @tparam N Capacity of the ring
+ *    @tparam Index Index type of the ring
+ *    @param  name Shown in the output
+ */
+template <size_t N, typename Index> static void checkThreads(const char* name) {
+  static Adafruit_MLX90632_SampleRing<N, Index> ring;
+  static mlx90632_sample_t out[N];
+  uint32_t popped = 0, retries = 0;
+  bool ok = true;
+
+  std::thread producer([&retries]() {
+    for (uint32_t seq = 0; seq < THREAD_SAMPLES; seq++) {
+      while (!ring.push(makeSample(seq))) {
+        retries++;
+        std::this_thread::yield();
+      }
+    }
+  });
+  // Keep draining after a mismatch, so the producer can finish
+  while (popped < THREAD_SAMPLES) {
+    Index n = ring.pop(out, N / 2);
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+    uint32_t seq = popped;
+    ok &= inSequence(out, n, &seq);
+    popped += n;
+  }
+  producer.join();
+  ok &= ring.available() == 0 && ring.getOverruns() == retries;
+
+  printf("%s: %lu samples across threads, %lu overruns: %s\n", name,
+         (unsigned long)popped, (unsigned long)retries, ok ? "OK" : "FAILED");
+  failed |= !ok;
+}
+
+/*!
+ *    @brief  Run the ring checks
+ *    @return 0 if all passed, 1 otherwise
+ */
+int main() {
+  checkRing<16, mlx90632_ring_index_t>("16 samples, host index");
+  checkRing<MLX90632_RING_MAX_SIZE, mlx90632_ring_index_t>(
+      "largest ring, host index");
+  checkRing<16, uint8_t>("16 samples, uint8_t index");
+  checkRing<128, uint8_t>("128 samples, uint8_t index");
+  checkThreads<16, mlx90632_ring_index_t>("16 samples, host index");
+  checkThreads<128, uint8_t>("128 samples, uint8_t index");
+
+  printf("%s\n", failed ? "FAILED" : "OK");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,265 @@
+/*!
+ *  @file Arduino.cpp
+ *
+ *  Virtual (or, with HOST_REAL_TIME, monotonic) clock and stdout Serial for
+ *  the host Arduino core.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "Arduino.h"
+
+#ifdef HOST_REAL_TIME
+#include <time.h>
+#endif
+
+#define HOST_EXIT_TIME_LIMIT 3 ///< Exit status when the time limit is hit
+
+HostSerial Serial;
+
+static uint32_t time_limit_ms = 0; ///< delay() past this exits, 0 = none
+
+#ifdef HOST_REAL_TIME
+
+/*!
+ *    @brief  Read the monotonic clock
+ *    @return Nanoseconds since an arbitrary point
+ */
+static uint64_t monotonicNanos() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static const uint64_t start_ns = monotonicNanos(); ///< Clock at start
+
+/*!
+ *    @brief  Get the time
+ *    @return Nanoseconds since start
+ */
+uint64_t hostNanos() {
+  return monotonicNanos() - start_ns;
+}
+
+/*!
+ *    @brief  Sleep
+ *    @param  ns Nanoseconds to sleep
+ */
+void hostAdvanceNanos(uint64_t ns) {
+  struct timespec ts = {(time_t)(ns / 1000000000ULL),
+                        (long)(ns % 1000000000ULL)};
+
+  while (nanosleep(&ts, &ts) != 0) {
+  }
+}
+
+#else
+
+static uint64_t clock_ns = 0; ///< Virtual time since start
+
+/*!
+ *    @brief  Get the virtual time
+ *    @return Nanoseconds since start
+ */
+uint64_t hostNanos() {
+  return clock_ns;
+}
+
+/*!
+ *    @brief  Advance the virtual time, e.g. by the duration of a bus transfer
+ *    @param  ns Nanoseconds to advance
+ */
+void hostAdvanceNanos(uint64_t ns) {
+  clock_ns += ns;
+}
+
+#endif
+
+/*!
+ *    @brief  Exit the process if delay() runs past a virtual time, so a
+ *            sketch stuck in `while (1) delay(10);` ends with an error
+ *    @param  ms Limit in milliseconds since start, 0 to disable
+ */
+void hostSetTimeLimit(uint32_t ms) {
+  time_limit_ms = ms;
+}
+
+/*!
+ *    @brief  Milliseconds of host time
+ *    @return Milliseconds since start
+ */
+unsigned long millis() {
+  return (unsigned long)(hostNanos() / 1000000ULL);
+}
+
+/*!
+ *    @brief  Microseconds of host time
+ *    @return Microseconds since start
+ */
+unsigned long micros() {
+  return (unsigned long)(hostNanos() / 1000ULL);
+}
+
+/*!
+ *    @brief  Wait, advancing the virtual time
+ *    @param  ms Milliseconds to wait
+ */
+void delay(unsigned long ms) {
+  hostAdvanceNanos((uint64_t)ms * 1000000ULL);
+  if (time_limit_ms && millis() >= time_limit_ms) {
+    fprintf(stderr, "Time limit of %u ms reached\n", (unsigned)time_limit_ms);
+    exit(HOST_EXIT_TIME_LIMIT);
+  }
+}
+
+/*!
+ *    @brief  Wait, advancing the virtual time
+ *    @param  us Microseconds to wait
+ */
+void delayMicroseconds(unsigned int us) {
+  hostAdvanceNanos((uint64_t)us * 1000ULL);
+}
+
+/*!
+ *    @brief  Nothing to yield to on the host
+ */
+void yield() {}
+
+/*!
+ *    @brief  Nothing to set up, stdout is always open
+ *    @param  baud Ignored
+ */
+void HostSerial::begin(unsigned long baud) {
+  (void)baud;
+}
+
+/*!
+ *    @brief  Print a string
+ *    @param  str String
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(const char* str) {
+  return (size_t)printf("%s", str);
+}
+
+/*!
+ *    @brief  Print an F() string
+ *    @param  str String
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(const __FlashStringHelper* str) {
+  return print(reinterpret_cast<const char*>(str));
+}
+
+/*!
+ *    @brief  Print a character
+ *    @param  c Character
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(char c) {
+  return (size_t)printf("%c", c);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(unsigned char value, int base) {
+  return print((unsigned long long)value, base);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(int value, int base) {
+  return print((long long)value, base);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(unsigned int value, int base) {
+  return print((unsigned long long)value, base);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(long value, int base) {
+  return print((long long)value, base);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(unsigned long value, int base) {
+  return print((unsigned long long)value, base);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(long long value, int base) {
+  if (base == DEC) {
+    return (size_t)printf("%lld", value);
+  }
+  // Like Arduino, other bases print the two's complement
+  return print((unsigned long long)value, base);
+}
+
+/*!
+ *    @brief  Print an integer
+ *    @param  value Value
+ *    @param  base DEC, HEX, OCT or BIN
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(unsigned long long value, int base) {
+  char buffer[65];
+  char* p = &buffer[sizeof(buffer) - 1];
+
+  if (base < 2 || base > 16) {
+    base = DEC;
+  }
+  *p = '\0';
+  do {
+    *--p = "0123456789ABCDEF"[value % base];
+    value /= base;
+  } while (value);
+  return print(p);
+}
+
+/*!
+ *    @brief  Print a floating point value
+ *    @param  value Value
+ *    @param  digits Digits after the decimal point
+ *    @return Number of characters printed
+ */
+size_t HostSerial::print(double value, int digits) {
+  return (size_t)printf("%.*f", digits, value);
+}
+
+/*!
+ *    @brief  Print a newline
+ *    @return Number of characters printed
+ */
+size_t HostSerial::println() {
+  return (size_t)printf("\n");
+}
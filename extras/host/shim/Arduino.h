@@ -0,0 +1,99 @@
+/*!
+ *  @file Arduino.h
+ *
+ *  Minimal Arduino core for building the MLX90632 library on a Linux host.
+ *
+ *  Time is virtual: it only advances through delay(), delayMicroseconds()
+ *  and simulated I2C bus traffic (see Wire.h), so host runs are fast and
+ *  repeatable. Built with HOST_REAL_TIME, it follows the monotonic clock
+ *  instead and delay() sleeps, for talking to real hardware.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LSBFIRST 0 ///< Least significant byte first
+#define MSBFIRST 1 ///< Most significant byte first
+
+#define BIN 2  ///< Binary print base
+#define OCT 8  ///< Octal print base
+#define DEC 10 ///< Decimal print base
+#define HEX 16 ///< Hexadecimal print base
+
+class __FlashStringHelper;
+/*! Flash strings are ordinary strings on the host */
+#define F(string_literal) \
+  (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+typedef bool boolean; ///< Arduino boolean type
+typedef uint8_t byte; ///< Arduino byte type
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Host extensions to drive the virtual clock
+uint64_t hostNanos();
+void hostAdvanceNanos(uint64_t ns);
+void hostSetTimeLimit(uint32_t ms);
+
+/*!
+ *    @brief  Serial port that prints to stdout
+ */
+class HostSerial {
+ public:
+  void begin(unsigned long baud);
+  /*! @brief Always connected @return true */
+  operator bool() {
+    return true;
+  }
+
+  size_t print(const char* str);
+  size_t print(const __FlashStringHelper* str);
+  size_t print(char c);
+  size_t print(unsigned char value, int base = DEC);
+  size_t print(int value, int base = DEC);
+  size_t print(unsigned int value, int base = DEC);
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(long long value, int base = DEC);
+  size_t print(unsigned long long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+
+  size_t println();
+  /*!
+   *    @brief  Print a value followed by a newline
+   *    @param  value Value to print
+   *    @return Number of characters printed
+   */
+  template <typename T>
+  size_t println(T value) {
+    return print(value) + println();
+  }
+  /*!
+   *    @brief  Print a value in a base or with a number of digits, followed
+   *            by a newline
+   *    @param  value Value to print
+   *    @param  format Base for integers, digits for floating point
+   *    @return Number of characters printed
+   */
+  template <typename T>
+  size_t println(T value, int format) {
+    return print(value, format) + println();
+  }
+};
+
+extern HostSerial Serial; ///< The host's only serial port
+
+#endif
@@ -0,0 +1,274 @@
+/*!
+ *  @file Wire.cpp
+ *
+ *  Host TwoWire that routes transfers to simulated I2C targets.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+/*!
+ *    @brief  Instantiates a bus with no devices at 100 kHz
+ */
+TwoWire::TwoWire() {
+  for (uint8_t i = 0; i < HOST_WIRE_MAX_TARGETS; i++) {
+    targets[i] = nullptr;
+    target_address[i] = 0;
+  }
+  clock_hz = 100000;
+  tx_address = 0;
+  tx_length = 0;
+  tx_overflow = false;
+  rx_length = 0;
+  rx_index = 0;
+  resetStats();
+}
+
+/*!
+ *    @brief  Nothing to set up on the host
+ */
+void TwoWire::begin() {}
+
+/*!
+ *    @brief  Nothing to release on the host
+ */
+void TwoWire::end() {}
+
+/*!
+ *    @brief  Set the SCL frequency used for the bus time
+ *    @param  hz Clock in Hz
+ */
+void TwoWire::setClock(uint32_t hz) {
+  clock_hz = hz;
+}
+
+/*!
+ *    @brief  Get the SCL frequency used for the bus time
+ *    @return Clock in Hz
+ */
+uint32_t TwoWire::getClock() {
+  return clock_hz;
+}
+
+/*!
+ *    @brief  Connect a simulated device to the bus
+ *    @param  address 7-bit address the device answers to
+ *    @param  target Device to connect
+ *    @return True if attached, false if the bus is full
+ */
+bool TwoWire::attach(uint8_t address, HostI2CTarget* target) {
+  detach(address);
+  for (uint8_t i = 0; i < HOST_WIRE_MAX_TARGETS; i++) {
+    if (!targets[i]) {
+      targets[i] = target;
+      target_address[i] = address;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ *    @brief  Disconnect the device at an address
+ *    @param  address 7-bit address
+ */
+void TwoWire::detach(uint8_t address) {
+  for (uint8_t i = 0; i < HOST_WIRE_MAX_TARGETS; i++) {
+    if (targets[i] && target_address[i] == address) {
+      targets[i] = nullptr;
+    }
+  }
+}
+
+/*!
+ *    @brief  Get the bus traffic counters
+ *    @return Counters since construction or the last resetStats()
+ */
+const host_i2c_stats_t& TwoWire::getStats() {
+  return stats;
+}
+
+/*!
+ *    @brief  Clear the bus traffic counters
+ */
+void TwoWire::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+/*!
+ *    @brief  Find the device at an address
+ *    @param  address 7-bit address
+ *    @return Device, or nullptr if none answers
+ */
+HostI2CTarget* TwoWire::findTarget(uint8_t address) {
+  for (uint8_t i = 0; i < HOST_WIRE_MAX_TARGETS; i++) {
+    if (targets[i] && target_address[i] == address) {
+      return targets[i];
+    }
+  }
+  return nullptr;
+}
+
+/*!
+ *    @brief  Count one transfer and advance the virtual clock by its time on
+ *            the wire: START, address byte, data bytes with their ACK bits,
+ *            and the STOP if there is one
+ *    @param  bytes Data bytes in the transfer
+ *    @param  stop True if the transfer ends with a STOP
+ */
+void TwoWire::busTime(size_t bytes, bool stop) {
+  uint64_t bits = 1 + 9 * (1 + bytes) + (stop ? 1 : 0);
+  uint64_t ns = (bits * 1000000000ULL + clock_hz - 1) / clock_hz;
+
+  stats.transfers++;
+  stats.bus_time_ns += ns;
+  hostAdvanceNanos(ns);
+}
+
+/*!
+ *    @brief  Start collecting bytes for a write transfer
+ *    @param  address 7-bit device address
+ */
+void TwoWire::beginTransmission(uint8_t address) {
+  tx_address = address;
+  tx_length = 0;
+  tx_overflow = false;
+}
+
+/*!
+ *    @brief  Queue a byte for the write transfer
+ *    @param  data Byte
+ *    @return 1, or 0 if the buffer is full
+ */
+size_t TwoWire::write(uint8_t data) {
+  if (tx_length >= HOST_WIRE_BUFFER_SIZE) {
+    tx_overflow = true;
+    return 0;
+  }
+  tx_buffer[tx_length++] = data;
+  return 1;
+}
+
+/*!
+ *    @brief  Queue bytes for the write transfer
+ *    @param  data Bytes
+ *    @param  len Number of bytes
+ *    @return Number of bytes queued
+ */
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (!write(data[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+/*!
+ *    @brief  Send the queued write transfer
+ *    @param  stop False to end with a repeated start
+ *    @return 0 on success, 1 if the data didn't fit, 2 on address NACK, 3 on
+ *            data NACK
+ */
+uint8_t TwoWire::endTransmission(bool stop) {
+  HostI2CTarget* target = findTarget(tx_address);
+
+  if (tx_overflow) {
+    return 1; // Data too long for the buffer
+  }
+  if (!target) {
+    busTime(0, true);
+    stats.nacks++;
+    return 2; // NACK on address
+  }
+  busTime(tx_length, stop);
+  if (!target->i2cWrite(tx_buffer, tx_length, stop)) {
+    stats.nacks++;
+    return 3; // NACK on data
+  }
+  stats.bytes_written += tx_length;
+  return 0;
+}
+
+/*!
+ *    @brief  Run a read transfer
+ *    @param  address 7-bit device address
+ *    @param  len Bytes to read, at most HOST_WIRE_BUFFER_SIZE
+ *    @param  stop False to end with a repeated start
+ *    @return Number of bytes received
+ */
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len, uint8_t stop) {
+  HostI2CTarget* target = findTarget(address);
+
+  rx_length = 0;
+  rx_index = 0;
+  if (len > HOST_WIRE_BUFFER_SIZE) {
+    len = HOST_WIRE_BUFFER_SIZE;
+  }
+  if (!target) {
+    busTime(0, true);
+    stats.nacks++;
+    return 0;
+  }
+  busTime(len, stop);
+  if (!target->i2cRead(rx_buffer, len)) {
+    stats.nacks++;
+    return 0;
+  }
+  rx_length = len;
+  stats.bytes_read += len;
+  return (uint8_t)len;
+}
+
+/*!
+ *    @brief  Run a read transfer that ends with a stop
+ *    @param  address 7-bit device address
+ *    @param  len Bytes to read
+ *    @return Number of bytes received
+ */
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len) {
+  return requestFrom(address, len, (uint8_t)1);
+}
+
+/*!
+ *    @brief  Run a read transfer, int variant as on AVR
+ *    @param  address 7-bit device address
+ *    @param  len Bytes to read
+ *    @return Number of bytes received
+ */
+uint8_t TwoWire::requestFrom(int address, int len) {
+  return requestFrom((uint8_t)address, (uint8_t)len, (uint8_t)1);
+}
+
+/*!
+ *    @brief  Run a read transfer, int variant as on AVR
+ *    @param  address 7-bit device address
+ *    @param  len Bytes to read
+ *    @param  stop False to end with a repeated start
+ *    @return Number of bytes received
+ */
+uint8_t TwoWire::requestFrom(int address, int len, int stop) {
+  return requestFrom((uint8_t)address, (uint8_t)len, (uint8_t)stop);
+}
+
+/*!
+ *    @brief  Bytes left from the last read transfer
+ *    @return Number of bytes
+ */
+int TwoWire::available() {
+  return (int)(rx_length - rx_index);
+}
+
+/*!
+ *    @brief  Next byte of the last read transfer
+ *    @return Byte, or -1 if none is left
+ */
+int TwoWire::read() {
+  if (rx_index >= rx_length) {
+    return -1;
+  }
+  return rx_buffer[rx_index++];
+}
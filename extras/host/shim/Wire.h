@@ -0,0 +1,106 @@
+/*!
+ *  @file Wire.h
+ *
+ *  Host TwoWire that routes transfers to simulated I2C targets.
+ *
+ *  Every transfer advances the virtual clock by its duration on the wire at
+ *  the setClock() rate, and is counted in host_i2c_stats_t.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#ifndef _HOST_WIRE_H
+#define _HOST_WIRE_H
+
+#include "Arduino.h"
+
+#ifndef HOST_WIRE_BUFFER_SIZE
+#define HOST_WIRE_BUFFER_SIZE 32 ///< Transmit/receive buffer, as on AVR
+#endif
+
+#define HOST_WIRE_MAX_TARGETS 8 ///< Simulated devices per bus
+
+/*!
+ *    @brief  A simulated device on a host I2C bus
+ */
+class HostI2CTarget {
+ public:
+  virtual ~HostI2CTarget() {}
+  /*!
+   *    @brief  Receive a write transfer
+   *    @param  data Bytes written by the controller
+   *    @param  len Number of bytes
+   *    @param  stop False if a repeated start follows
+   *    @return True to ACK, false to NACK
+   */
+  virtual bool i2cWrite(const uint8_t* data, size_t len, bool stop) = 0;
+  /*!
+   *    @brief  Supply the bytes of a read transfer
+   *    @param  data Buffer to fill
+   *    @param  len Number of bytes requested
+   *    @return True to ACK the address, false to NACK
+   */
+  virtual bool i2cRead(uint8_t* data, size_t len) = 0;
+};
+
+/*!
+ *    @brief  Bus traffic since the last resetStats()
+ */
+typedef struct {
+  uint32_t transfers;     ///< Address phases, including repeated starts
+  uint32_t bytes_written; ///< Data bytes written, excluding address bytes
+  uint32_t bytes_read;    ///< Data bytes read
+  uint32_t nacks;         ///< Transfers NACKed by the target or unanswered
+  uint64_t bus_time_ns;   ///< Time on the wire at the configured clock
+} host_i2c_stats_t;
+
+/*!
+ *    @brief  Arduino TwoWire API on top of simulated targets
+ */
+class TwoWire {
+ public:
+  TwoWire();
+  void begin();
+  void end();
+  void setClock(uint32_t hz);
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t* data, size_t len);
+  uint8_t endTransmission(bool stop = true);
+  // The AVR overload set, so that ambiguous calls fail here as on an Uno
+  uint8_t requestFrom(uint8_t address, uint8_t len);
+  uint8_t requestFrom(uint8_t address, uint8_t len, uint8_t stop);
+  uint8_t requestFrom(int address, int len);
+  uint8_t requestFrom(int address, int len, int stop);
+  int available();
+  int read();
+
+  // Host extensions
+  bool attach(uint8_t address, HostI2CTarget* target);
+  void detach(uint8_t address);
+  uint32_t getClock();
+  const host_i2c_stats_t& getStats();
+  void resetStats();
+
+ private:
+  HostI2CTarget* findTarget(uint8_t address);
+  void busTime(size_t bytes, bool stop);
+
+  uint8_t target_address[HOST_WIRE_MAX_TARGETS]; ///< Attached addresses
+  HostI2CTarget* targets[HOST_WIRE_MAX_TARGETS]; ///< Attached devices
+  uint32_t clock_hz;                             ///< SCL frequency
+
+  uint8_t tx_address;                       ///< Address of the transmission
+  uint8_t tx_buffer[HOST_WIRE_BUFFER_SIZE]; ///< Bytes to transmit
+  size_t tx_length;                         ///< Bytes in tx_buffer
+  bool tx_overflow;                         ///< write() ran out of buffer
+  uint8_t rx_buffer[HOST_WIRE_BUFFER_SIZE]; ///< Bytes received
+  size_t rx_length;                         ///< Bytes in rx_buffer
+  size_t rx_index;                          ///< Next byte for read()
+
+  host_i2c_stats_t stats; ///< Traffic counters
+};
+
+extern TwoWire Wire; ///< The default host bus
+
+#endif
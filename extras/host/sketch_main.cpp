@@ -0,0 +1,56 @@
+/*!
+ *  @file sketch_main.cpp
+ *
+ *  Runs an Arduino example sketch on the host against simulated MLX90632s
+ *  at 0x3A and 0x3B.
+ *
+ *  Usage: <sketch> [seconds]
+ *
+ *  Calls setup() once and loop() until the given virtual time (default 10
+ *  seconds) has passed. Exits with status 3 if setup() doesn't return within
+ *  a minute of virtual time, e.g. because it got stuck in an error loop.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include "MLX90632_Simulator.h"
+
+#define LOOP_OVERHEAD_NS 10000 ///< Virtual time charged per loop() call
+
+void setup();
+void loop();
+
+/*!
+ *    @brief  Attach the simulators and run the sketch
+ *    @param  argc Argument count
+ *    @param  argv Arguments, the optional run time in seconds
+ *    @return 0, or 3 if setup() got stuck
+ */
+int main(int argc, char** argv) {
+  unsigned long run_ms = 10000;
+  MLX90632_Simulator sensor0;
+  MLX90632_Simulator sensor1;
+
+  if (argc > 1) {
+    run_ms = strtoul(argv[1], nullptr, 10) * 1000UL;
+  }
+
+  sensor0.setNoise(2);
+  sensor1.setAmbientTemperature(23.5);
+  sensor1.setObjectTemperature(31.2);
+  sensor1.setNoise(2);
+  sensor0.begin(0x3A);
+  sensor1.begin(0x3B);
+
+  hostSetTimeLimit(60000);
+  setup();
+  hostSetTimeLimit(0);
+
+  run_ms += millis();
+  while (millis() < run_ms) {
+    loop();
+    // Sketches that only poll would otherwise never see time pass
+    hostAdvanceNanos(LOOP_OVERHEAD_NS);
+  }
+  return 0;
+}
@@ -0,0 +1,250 @@
+/*!
+ *  @file trace_demo.cpp
+ *
+ *  Records the bus trace of a driver reading the simulator, then replays
+ *  it into a second driver through the mock transport and checks that the
+ *  replay gives bit-identical frames and temperatures.
+ *
+ *  The recorder flushes through a small buffer into a host-side store, as
+ *  it would to a file on SD. The replay advances the virtual clock to each
+ *  record's time, so poll() schedules the same transactions it did while
+ *  recording.
+ *
+ *  Exits with status 1 if the replay diverges.
+ *
+ *  MIT license, see LICENSE for more information
+ */
+
+#include <chrono>
+
+#include "MLX90632_Simulator.h"
+
+#define SAMPLES 64              ///< Samples per measurement type
+#define RECORD_BUFFER 512       ///< Recorder buffer, flushed when full
+#define STORE_SIZE (256 * 1024) ///< Host-side trace store
+#define REPLAY_PASSES 20        ///< Replays timed for the throughput
+
+/*!
+ *    @brief  One sample as seen by the driver
+ */
+typedef struct {
+  mlx90632_frame_t frame; ///< Raw RAM words
+  double ambient;         ///< Ambient temperature
+  double object;          ///< Object temperature
+} demo_sample_t;
+
+static MLX90632_Simulator sensor;
+static uint8_t store[STORE_SIZE]; ///< Flushed trace bytes
+static size_t store_length = 0;   ///< Bytes in store
+static demo_sample_t recorded[2 * SAMPLES];
+static demo_sample_t replayed[2 * SAMPLES];
+
+/*!
+ *    @brief  Mock bus handler that passes transactions to the simulator
+ *    @param  context The simulator
+ *    @param  addr Device address, the simulator answers any
+ *    @param  write_data Bytes written
+ *    @param  write_len Number of bytes written
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read
+ *    @return True if the simulator acknowledged
+ */
+static bool simulatorHandler(void* context, uint8_t addr,
+                             const uint8_t* write_data, size_t write_len,
+                             uint8_t* read_data, size_t read_len) {
+  MLX90632_Simulator* sim = static_cast<MLX90632_Simulator*>(context);
+
+  (void)addr;
+  if (!sim->i2cWrite(write_data, write_len, read_len == 0)) {
+    return false;
+  }
+  return read_len == 0 || sim->i2cRead(read_data, read_len);
+}
+
+static uint64_t replay_base_ns = 0; ///< Virtual time the replay started
+
+/*!
+ *    @brief  Mock bus handler that answers from the trace and brings the
+ *            virtual clock up to the recorded time
+ *    @param  context The Adafruit_MLX90632_TraceReplay
+ *    @param  addr Device address
+ *    @param  write_data Bytes written
+ *    @param  write_len Number of bytes written
+ *    @param  read_data Buffer for the bytes read
+ *    @param  read_len Number of bytes to read
+ *    @return The recorded result
+ */
+static bool replayHandler(void* context, uint8_t addr,
+                          const uint8_t* write_data, size_t write_len,
+                          uint8_t* read_data, size_t read_len) {
+  Adafruit_MLX90632_TraceReplay* replay =
+      static_cast<Adafruit_MLX90632_TraceReplay*>(context);
+  bool ok = Adafruit_MLX90632_TraceReplay::handler(
+      context, addr, write_data, write_len, read_data, read_len);
+  uint64_t at = replay_base_ns + replay->getTimestamp() * 1000ULL;
+
+  if (at > hostNanos()) {
+    hostAdvanceNanos(at - hostNanos());
+  }
+  return ok;
+}
+
+/*!
+ *    @brief  Recorder flush callback, appends to the host store
+ *    @param  context Unused
+ *    @param  data Trace bytes
+ *    @param  len Number of bytes
+ *    @return False if the store is full
+ */
+static bool storeTrace(void* context, const uint8_t* data, size_t len) {
+  (void)context;
+  if (store_length + len > sizeof(store)) {
+    return false;
+  }
+  memcpy(store + store_length, data, len);
+  store_length += len;
+  return true;
+}
+
+/*!
+ *    @brief  Move the virtual clock to the next whole millisecond, so the
+ *            recording and the replay start on the same phase
+ */
+static void alignClock() {
+  hostAdvanceNanos(1000000ULL - hostNanos() % 1000000ULL);
+}
+
+/*!
+ *    @brief  Set up a driver and take samples in both measurement types,
+ *            with the object temperature ramping while sampling
+ *    @param  mlx Driver, not begun
+ *    @param  bus Bus to begin it on
+ *    @param  samples Where to store the samples
+ *    @param  simulate True to drive the simulator's temperatures
+ *    @return True if every step succeeded
+ */
+static bool session(Adafruit_MLX90632& mlx, mlx90632_mock_bus_t* bus,
+                    demo_sample_t* samples, bool simulate) {
+  static const mlx90632_meas_select_t types[] = {MLX90632_MEAS_MEDICAL,
+                                                 MLX90632_MEAS_EXTENDED_RANGE};
+
+  if (!mlx.begin(MLX90632_DEFAULT_ADDR, bus) ||
+      !mlx.setRefreshRate(MLX90632_REFRESH_16HZ) ||
+      !mlx.setMode(MLX90632_MODE_CONTINUOUS)) {
+    return false;
+  }
+  for (uint8_t t = 0; t < 2; t++) {
+    if (!mlx.setMeasurementSelect(types[t])) {
+      return false;
+    }
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+      if (simulate) {
+        sensor.setObjectTemperature(30.0 + 0.1 * i);
+      }
+      while (mlx.poll() != MLX90632_STATE_READY) {
+        delay(1);
+      }
+      demo_sample_t& s = samples[t * SAMPLES + i];
+      s.frame = mlx.getLastFrame();
+      s.ambient = mlx.getLastAmbientTemperature();
+      s.object = mlx.getLastObjectTemperature();
+    }
+  }
+  return true;
+}
+
+/*!
+ *    @brief  Replay the stored trace into a fresh driver
+ *    @param  replay Replay to use
+ *    @return True if the session ran to the end of the trace
+ */
+static bool replaySession(Adafruit_MLX90632_TraceReplay& replay) {
+  mlx90632_mock_bus_t bus = {replayHandler, &replay, HOST_WIRE_BUFFER_SIZE,
+                             false, {}, 0, 0};
+  Adafruit_MLX90632 mlx;
+
+  alignClock();
+  replay_base_ns = hostNanos();
+  // A diverging replay would stall poll(), so bound it in virtual time
+  hostSetTimeLimit(millis() + 600000UL);
+  bool ok = replay.begin(store, store_length) &&
+            session(mlx, &bus, replayed, false);
+  hostSetTimeLimit(0);
+  return ok;
+}
+
+/*!
+ *    @brief  Compare two samples bit for bit, over the RAM words their
+ *            measurement type uses
+ *    @param  a First sample
+ *    @param  b Second sample
+ *    @return True if they are identical
+ */
+static bool sameSample(const demo_sample_t& a, const demo_sample_t& b) {
+  uint8_t words = a.frame.meas_select == MLX90632_MEAS_MEDICAL ? 6 : 8;
+
+  return a.frame.meas_select == b.frame.meas_select &&
+         a.frame.cycle_position == b.frame.cycle_position &&
+         memcmp(a.frame.ram, b.frame.ram, 2 * words) == 0 &&
+         memcmp(&a.ambient, &b.ambient, sizeof(double)) == 0 &&
+         memcmp(&a.object, &b.object, sizeof(double)) == 0;
+}
+
+/*!
+ *    @brief  Record, replay and compare
+ *    @return 0 if the replay matched, 1 otherwise
+ */
+int main() {
+  static uint8_t buffer[RECORD_BUFFER];
+  mlx90632_mock_bus_t bus = {simulatorHandler, &sensor, HOST_WIRE_BUFFER_SIZE,
+                             false, {}, 0, 0};
+  Adafruit_MLX90632_TraceRecorder recorder;
+  Adafruit_MLX90632_TraceReplay replay;
+  Adafruit_MLX90632 mlx;
+
+  sensor.setNoise(20);
+  sensor.begin();
+  alignClock();
+  if (!recorder.begin(buffer, sizeof(buffer), storeTrace)) {
+    printf("recorder begin() failed\n");
+    return 1;
+  }
+  mlx.setTrace(&recorder);
+  if (!session(mlx, &bus, recorded, true) || !recorder.flush() ||
+      recorder.getDroppedCount()) {
+    printf("recording failed\n");
+    return 1;
+  }
+  printf("Recorded %lu transactions in %lu bytes, %.1f bytes/sample\n",
+         (unsigned long)recorder.getRecordCount(), (unsigned long)store_length,
+         (double)store_length / (2 * SAMPLES));
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint8_t pass = 0; pass < REPLAY_PASSES; pass++) {
+    if (!replaySession(replay)) {
+      printf("replay failed after %lu records, %lu mismatches\n",
+             (unsigned long)replay.getRecordCount(),
+             (unsigned long)replay.getMismatchCount());
+      return 1;
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+  bool match = replay.atEnd() && replay.getMismatchCount() == 0 &&
+               replay.getRecordCount() == recorder.getRecordCount();
+  for (uint16_t i = 0; i < 2 * SAMPLES; i++) {
+    if (!sameSample(recorded[i], replayed[i])) {
+      printf("sample %u differs\n", i);
+      match = false;
+      break;
+    }
+  }
+  printf("Replayed %lu records in %.3f ms per pass (%.0f records/s), %lu "
+         "mismatches\n",
+         (unsigned long)replay.getRecordCount(), seconds * 1000 / REPLAY_PASSES,
+         replay.getRecordCount() * REPLAY_PASSES / seconds,
+         (unsigned long)replay.getMismatchCount());
+  printf("%s\n", match ? "OK" : "FAILED");
+  return match ? 0 : 1;
+}